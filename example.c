@@ -38,6 +38,7 @@ static void buttonCallback(const g_event *event,
   if(event->type == G_CLICK_LEFT)
   {
     strcpy(widget->window->title, input_box->input.text);
+    g_damage_window(widget->window);
   }
 }
 
@@ -47,17 +48,32 @@ static void checkboxCallback(const g_event *event,
 {
   g_widget *input_box = user_data;
 
-  if(event->type == G_CLICK_LEFT)
+  if(event->type == G_VALUE_CHANGED)
   {
     input_box->input.flags.hide_text = widget->check.state;
+    g_damage_widget(input_box);
   }
 }
 
+static void clearBackground(SDL_Surface *screen,
+                            const SDL_Rect *rect,
+                            void *user_data)
+{
+  (void)user_data;
+
+  SDL_FillRect(screen, (SDL_Rect *)rect,
+               SDL_MapRGB(screen->format, 0xff, 0xff, 0xff));
+}
+
 static g_window *createDemoWindow(int x, int y)
 {
   g_window *window = g_create_window(x, y, 400, 300, "Test Window");
   window->flags.close_button = 0;
 
+  /* Keep a copy of the drawn window. This only takes effect on windows with
+     an opaque theme. */
+  window->flags.cached = 1;
+
   /* Attach text input elements. A width/height of 0 will cause the widget
      to fit by expanding to the right/bottom. */
   g_attach_text(window, 0, 0, 0, 0, "Insert window title:");
@@ -113,21 +129,52 @@ int main(void)
     die("failed to initialize GUI engine");
   }
 
+  /* The callbacks of this example only care about clicks and changed values. */
+  g_get_setting_struct()->widget_event_mask = G_EVENT_MASK_CLICKS | G_EVENT_MASK(G_VALUE_CHANGED);
+
   g_window *first_window = createDemoWindow(250, 200);
 
-  /* Set the global default theme. This will only affect windows/widgets
-     created after this call. */
+  /* Change the default theme. This also recolors the window created
+     before, since its widgets don't keep own copies of the colors. */
   setExampleTheme();
 
   createDemoWindow(50, 50);
 
   g_raise_window(first_window);
 
+  /* Let the GUI clear regions before redrawing them. */
+  g_set_background_function(clearBackground, NULL);
+
+  /* Handle dragging once per frame, instead of once per mouse event. */
+  g_set_motion_coalescing(1);
+
+  /* Call event functions from the main loop, instead of SDL's event filter. */
+  g_set_deferred_events(1);
+
   /* Main loop. */
   bool running = true;
   while(running)
   {
     SDL_Event event;
+
+    /* Sleep until the GUI has changed. SDL_WaitEvent() gets woken up by the
+       GUI, but changes without user input, like pop-ups, must be waited for. */
+    if(!g_needs_redraw())
+    {
+      const int timeout = g_get_redraw_timeout();
+      if(timeout < 0)
+      {
+        if(SDL_WaitEvent(&event) && event.type == SDL_QUIT)
+        {
+          running = false;
+        }
+      }
+      else
+      {
+        SDL_Delay(timeout < 16 ? timeout : 16);
+      }
+    }
+
     while(SDL_PollEvent(&event))
     {
       if(event.type == SDL_QUIT)
@@ -136,15 +183,15 @@ int main(void)
       }
     }
 
-    /* Clear screen. */
-    SDL_FillRect(screen, NULL, SDL_MapRGB(screen->format, 0xff, 0xff, 0xff));
+    /* Run the event functions queued while handling the events above. */
+    g_dispatch_events();
 
-    /* Draw GUI. */
-    g_draw_everything(screen);
+    /* Redraw only the parts of the GUI which have changed. */
+    SDL_Rect rects[G_MAX_DAMAGE_RECTS];
+    int rect_count = g_draw_damaged(screen, rects, G_MAX_DAMAGE_RECTS);
 
-    /* Update screen and keep framerate. */
-    SDL_Flip(screen);
-    SDL_Delay(16);
+    /* Update changed screen regions. */
+    SDL_UpdateRects(screen, rect_count, rects);
   }
 
   SDL_FreeSurface(screen);
@@ -22,6 +22,14 @@
 
 #include "gui_engine.h"
 
+#include <stddef.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 static g_window *first_window = NULL;
 static g_window *last_window = NULL;
 
@@ -39,55 +47,305 @@ static g_widget *clicked_slider = NULL;
 static g_widget *active_drop_down_list = NULL;
 static g_widget *active_input_box = NULL;
 
+/* the widget below the mouse, which has received G_MOUSE_ENTER */
+static g_widget *entered_widget = NULL;
+
+/* the widget, whose value has been changed by the current event */
+static g_widget *changed_widget = NULL;
+
+/* the dragged slider with the 'changes_per_frame' flag and its value at the last G_VALUE_CHANGED */
+static g_widget *delayed_slider = NULL;
+static double delayed_slider_value;
+
 static int key_repeat_delay, key_repeat_interval;
 
 static g_window *grab_keyboard_window = NULL;
 static g_widget *grab_keyboard_widget = NULL;
 
+/* damaged regions on the video surface, which must be redrawn by g_draw_damaged() */
+static SDL_Rect damage_rects[G_MAX_DAMAGE_RECTS];
+static int damage_rect_amount = 0;
+static int damage_everything = 0;
+static int redraw_event_pushed = 0;
+
+/* mouse motion events are merged into 'pending_motion' until the next frame or the next other event */
+static int coalesce_motion = 0;
+static int motion_pending = 0;
+static SDL_Event pending_motion;
+
+/* event function calls waiting for g_dispatch_events(); the ring grows beyond G_MAX_QUEUED_EVENTS */
+/* calls, when it contains no mouse motion calls, which can be dropped instead */
+static struct g_queued_event{
+  g_event event;
+  g_window *window;
+  g_widget *widget;
+}*event_queue = NULL;
+static int event_queue_size = 0;
+static int event_queue_first = 0;
+static int event_queue_amount = 0;
+static int defer_events = 0;
+
+/* events passed from SDL's event thread to the drawing thread */
+/* only the event filter writes to the queue, only the drawing thread reads from it */
+static SDL_Event input_queue[G_MAX_INPUT_EVENTS];
+static int input_queue_read = 0;
+static int input_queue_write = 0;
+static int input_wake_pushed = 0;
+static int threaded_events = 0;
+
+/* the window and widget below the mouse and the screen area, in which they stay the same */
+static struct{
+  g_window *window;
+  
+  /* grid index of the widget or -1, terminated like a grid cell */
+  int entries[2];
+  int x1, y1, x2, y2;
+  
+  /* counts how often the remembered area has been dropped */
+  Uint32 changes;
+}hover = {NULL, {-1, -1}, 0, 0, 0, 0, 0};
+
+static void (*background_function)(SDL_Surface *, const SDL_Rect *, void *) = NULL;
+static void *background_data = NULL;
+
+/* pre-rendered fonts, to avoid drawing every character with SDL_gfx */
+static struct{
+  SDL_Surface *surface;
+  struct g_color_struct color;
+  Uint32 last_use;
+}glyph_sheets[G_GLYPH_SHEETS];
+static Uint32 glyph_sheet_uses = 0;
+
+/* pre-rendered gradients, to avoid drawing them line by line */
+static struct{
+  SDL_Surface *surface;
+  struct g_color_struct top;
+  struct g_color_struct bottom;
+  int h;
+  Uint32 last_use;
+}gradient_strips[G_GRADIENT_STRIPS];
+static Uint32 gradient_strip_uses = 0;
+
+/* colors mapped to the pixel format of the destination surface, to avoid SDL_MapRGBA() on every fill */
+/* every entry holds the color as 0xRRGGBBAA in the upper and its pixel value in the lower 32 bits */
+static Uint64 mapped_colors[G_MAPPED_COLORS];
+static SDL_PixelFormat mapped_format;
+
+/* parallel rendering; the first render target belongs to the thread calling the draw function */
+static SDL_Thread *render_threads[G_MAX_RENDER_THREADS];
+static SDL_Surface *render_targets[G_MAX_RENDER_THREADS];
+static SDL_Surface *render_blit_target = NULL;
+static int render_thread_amount = 0;
+static int render_active = 0;
+static int render_quit = 0;
+static SDL_sem *render_start = NULL;
+static SDL_sem *render_done = NULL;
+static SDL_mutex *render_lock = NULL;
+
+static SDL_Rect *render_tiles = NULL;
+static int render_tile_amount = 0;
+static int render_tile_capacity = 0;
+static int render_next_tile = 0;
+
+/* cache entries used after these values were taken may not be replaced during parallel rendering */
+static Uint32 glyph_frame_uses = 0;
+static Uint32 gradient_frame_uses = 0;
+
 /* gui defaults */
 static g_setting_struct g_defaults;
 
+/* theme of windows and widgets without an own theme */
+static g_theme builtin_theme;
+static g_theme *default_theme = &builtin_theme;
+
+/* functions of the built-in and registered widget types, indexed by g_widget_type */
+static g_widget_class widget_classes[G_MAX_WIDGET_TYPES];
+static int widget_type_amount = G_TYPE_CUSTOM;
+
+/* size of a widget, whose union holds 'data', i.e. G_WIDGET_SIZE(struct g_widget_slider) */
+#define G_WIDGET_SIZE(data) (offsetof(struct g_widget, custom) + sizeof(data))
+
+/* size of the built-in widget types, indexed by g_widget_type; custom widgets only store a pointer */
+static const size_t widget_sizes[G_TYPE_CUSTOM] = {
+  G_WIDGET_SIZE(struct g_widget_text),
+  G_WIDGET_SIZE(struct g_widget_input_box),
+  G_WIDGET_SIZE(struct g_widget_button),
+  G_WIDGET_SIZE(struct g_widget_check_box),
+  G_WIDGET_SIZE(struct g_widget_surface),
+  G_WIDGET_SIZE(struct g_widget_slider),
+  G_WIDGET_SIZE(struct g_widget_slider),
+  G_WIDGET_SIZE(struct g_widget_drop_down_list)
+};
+
+/* memory block of a window, which widgets are taken from one after another */
+struct g_widget_block{
+  struct g_widget_block *next;
+  size_t used, size;
+  
+  /* the widgets; the type keeps them aligned for all their members */
+  double data[];
+};
+
+/* memory of a destroyed widget, which is reused for the next widget of the same size */
+struct g_unused_widget{
+  struct g_unused_widget *next;
+  size_t size;
+};
+
 /* core functions start */
-static g_widget *g_attach_raw_widged(g_window *window)
+/* returns a copy of 'text' in memory of its size, cut off after G_TEXT_LENGTH - 1 characters */
+static char *g_copy_text(const char *text)
+{
+  char *copy;
+  size_t length;
+  
+  if(!text)
+    text = "";
+  
+  length = strlen(text);
+  if(length > G_TEXT_LENGTH - 1)
+    length = G_TEXT_LENGTH - 1;
+  
+  copy = malloc(length + 1);
+  if(!copy)
+    return NULL;
+  
+  memcpy(copy, text, length);
+  copy[length] = '\0';
+  
+  return copy;
+}
+/* returns the memory needed by a widget of 'type' */
+static size_t g_get_widget_size(const int type)
+{
+  size_t size;
+  
+  if(type < G_TYPE_CUSTOM)
+    size = widget_sizes[type];
+  else
+    size = G_WIDGET_SIZE(void *);
+  
+  /* keep the next widget in the block aligned */
+  return (size + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+}
+/* takes the memory for a widget of 'type' from the blocks of the window */
+static g_widget *g_alloc_widget(g_window *window, const int type)
+{
+  struct g_unused_widget **unused;
+  struct g_widget_block *block = window->widget_blocks;
+  size_t size = g_get_widget_size(type);
+  size_t block_size;
+  g_widget *widget;
+  
+  /* reuse the memory of a destroyed widget */
+  for(unused = &window->unused_widgets; *unused; unused = &(*unused)->next)
+  {
+    if((*unused)->size == size)
+    {
+      widget = (g_widget *)*unused;
+      *unused = (*unused)->next;
+      
+      return widget;
+    }
+  }
+  
+  if(!block || block->used + size > block->size)
+  {
+    /* every block is twice as big as the one before */
+    block_size = block ? block->size * 2 : G_WIDGET_BLOCK_SIZE;
+    while(block_size < size)
+      block_size *= 2;
+    
+    block = malloc(sizeof(struct g_widget_block) + block_size);
+    if(!block)
+      return NULL;
+    
+    block->next = window->widget_blocks;
+    block->used = 0;
+    block->size = block_size;
+    window->widget_blocks = block;
+  }
+  
+  widget = (g_widget *)((char *)block->data + block->used);
+  block->used += size;
+  
+  return widget;
+}
+/* keeps the memory of a destroyed widget for the next widget of its window */
+static void g_free_widget(g_widget *widget)
+{
+  struct g_unused_widget *unused = (struct g_unused_widget *)widget;
+  g_window *window = widget->window;
+  size_t size = g_get_widget_size(widget->type);
+  
+  unused->size = size;
+  unused->next = window->unused_widgets;
+  window->unused_widgets = unused;
+}
+static void g_free_widget_blocks(g_window *window)
+{
+  struct g_widget_block *block;
+  
+  while(window->widget_blocks)
+  {
+    block = window->widget_blocks;
+    window->widget_blocks = block->next;
+    free(block);
+  }
+  
+  window->unused_widgets = NULL;
+}
+static g_widget *g_attach_raw_widged(g_window *window, const int type)
 {
+  g_widget *widget;
+  
   if(!window)
     return NULL;
   
-  /* allocate memory and set new widget to window->last_widget */
+  widget = g_alloc_widget(window, type);
+  if(!widget)
+    return NULL;
+  
+  /* set new widget to window->last_widget */
   if(!window->first_widget)
   {
-    window->first_widget = malloc(sizeof(struct g_widget));
-    if(!window->first_widget)
-      return NULL;
+    window->first_widget = widget;
     
-    window->first_widget->next = NULL;
-    window->first_widget->prev = NULL;
-    window->last_widget = window->first_widget;
+    widget->next = NULL;
+    widget->prev = NULL;
+    window->last_widget = widget;
   }
   else
   {
-    window->last_widget->next = malloc(sizeof(struct g_widget));
-    if(!window->last_widget->next)
-      return NULL;
+    window->last_widget->next = widget;
     
-    window->last_widget->next->prev = window->last_widget;
-    window->last_widget->next->next = NULL;
-    window->last_widget = window->last_widget->next;
+    widget->prev = window->last_widget;
+    widget->next = NULL;
+    window->last_widget = widget;
   }
   
-  window->last_widget->window = window;
+  widget->type = type;
+  widget->window = window;
+  
+  widget->pop_up_delay = g_defaults.pop_up_delay;
+  widget->pop_up = NULL;
   
-  window->last_widget->pop_up_delay = g_defaults.pop_up_delay;
-  window->last_widget->pop_up = NULL;
+  widget->event_function = NULL;
+  widget->event_data = NULL;
   
-  window->last_widget->event_function = NULL;
-  window->last_widget->event_data = NULL;
+  widget->event_mask = g_defaults.widget_event_mask;
+  widget->theme = NULL;
   
-  return window->last_widget;
+  widget->layout.valid = 0;
+  
+  window->hit_grid.valid = 0;
+  g_damage_window(window);
+  
+  return widget;
 }
-static g_widget *g_attach_slider_raw(g_window *window, const double value, const double max_value)
+static g_widget *g_attach_slider_raw(g_window *window, const g_widget_type type, const double value, const double max_value)
 {
-  g_widget *widget = g_attach_raw_widged(window);
+  g_widget *widget = g_attach_raw_widged(window, type);
   
   if(!widget)
     return NULL;
@@ -104,808 +362,3084 @@ static g_widget *g_attach_slider_raw(g_window *window, const double value, const
   
   widget->slider.flags.invert = g_defaults.slider.flags.invert;
   widget->slider.flags.mouse_wheel = g_defaults.slider.flags.mouse_wheel;
+  widget->slider.flags.changes_per_frame = g_defaults.slider.flags.changes_per_frame;
   
-  /* set colors to default */
-  widget->slider.color.slider.r = g_defaults.slider.color.slider.r;
-  widget->slider.color.slider.g = g_defaults.slider.color.slider.g;
-  widget->slider.color.slider.b = g_defaults.slider.color.slider.b;
-  widget->slider.color.slider.a = g_defaults.slider.color.slider.a;
-  
-  widget->slider.color.frame.r = g_defaults.slider.color.frame.r;
-  widget->slider.color.frame.g = g_defaults.slider.color.frame.g;
-  widget->slider.color.frame.b = g_defaults.slider.color.frame.b;
-  widget->slider.color.frame.a = g_defaults.slider.color.frame.a;
-  
-  widget->slider.color.line.r = g_defaults.slider.color.line.r;
-  widget->slider.color.line.g = g_defaults.slider.color.line.g;
-  widget->slider.color.line.b = g_defaults.slider.color.line.b;
-  widget->slider.color.line.a = g_defaults.slider.color.line.a;
+  /* use the colors of the theme */
+  widget->slider.color = NULL;
   
   return widget;
 }
-static void g_draw_text(SDL_Surface *dst, const char *text,
-                        const int x, const int y, const int w, const int h,
-                        const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a)
+/* returns 1 if colors can be copied between both formats without conversion */
+static int g_same_format(const SDL_PixelFormat *a, const SDL_PixelFormat *b)
 {
-  int dest_x, dest_y;
-  int counter;
-  
-  /* draw text loop */
-  dest_x = x;
-  dest_y = y;
-  for(counter = 0; text[counter] != '\0' && dest_y < y + h; counter++)
-  {
-    if(text[counter] != '\n')
-      characterRGBA(dst, dest_x, dest_y, text[counter], r, g, b, a);
-    
-    if(dest_x + G_CHAR_W < x + w && text[counter] != '\n')
-    {
-      dest_x += G_CHAR_W;
-    }
-    else
-    {
-      dest_x = x;
-      dest_y += G_CHAR_H;
-    }
-  }
+  return a->BitsPerPixel == b->BitsPerPixel &&
+         a->Rmask == b->Rmask && a->Gmask == b->Gmask && a->Bmask == b->Bmask;
 }
-static void g_mark_window_as_selected_pop_up(g_window *window, const Uint32 delay)
+/* serializes SDL and SDL_gfx calls, which are not thread safe, during parallel rendering */
+static void g_lock_renderer(void)
 {
-  selected_pop_up_window = window;
-  selected_pop_up_timestop = SDL_GetTicks();
-  selected_pop_up_delay = delay;
+  if(render_active)
+    SDL_mutexP(render_lock);
 }
-
-/* returns adjustet position in window, not on video surface */
-static void g_adjust_widget_position(const g_widget *widget, int *x, int *y, int *w, int *h)
+static void g_unlock_renderer(void)
 {
-  g_window *window = widget->window;
+  if(render_active)
+    SDL_mutexV(render_lock);
+}
+/* replacement for SDL_BlitSurface(); during parallel rendering plain and colorkey copies, like */
+/* glyphs, are done without SDL */
+static void g_blit_surface(SDL_Surface *src, SDL_Rect *src_rect, SDL_Surface *dst, SDL_Rect *dst_rect)
+{
+  Uint8 *from, *to;
+  Uint32 colorkey;
+  int src_x, src_y;
+  int x, y, w, h;
+  int counter;
   
-  /* widget position in window cant be smaller than window->margin */
-  if(widget->x < window->margin)
-    *x = window->margin;
-  else
-    *x = widget->x;
+  if(!render_active)
+  {
+    SDL_BlitSurface(src, src_rect, dst, dst_rect);
+    return;
+  }
   
-  if(widget->y < window->margin)
-    *y = window->margin;
+  /* SDL stores a blit map in 'src', so every blit by SDL must go to the same destination surface */
+  if((src->flags & SDL_SRCALPHA) || SDL_MUSTLOCK(src) || !g_same_format(src->format, dst->format) ||
+     ((src->flags & SDL_SRCCOLORKEY) && src->format->BytesPerPixel != 2 && src->format->BytesPerPixel != 4))
+  {
+    SDL_mutexP(render_lock);
+    SDL_SetClipRect(render_blit_target, &dst->clip_rect);
+    SDL_BlitSurface(src, src_rect, render_blit_target, dst_rect);
+    SDL_mutexV(render_lock);
+    return;
+  }
+  
+  if(src_rect)
+  {
+    src_x = src_rect->x;
+    src_y = src_rect->y;
+    w = src_rect->w;
+    h = src_rect->h;
+  }
   else
-    *y = widget->y;
+  {
+    src_x = 0;
+    src_y = 0;
+    w = src->w;
+    h = src->h;
+  }
   
-  /* widget cant be bigger then window */
-  if(w)
+  x = dst_rect ? dst_rect->x : 0;
+  y = dst_rect ? dst_rect->y : 0;
+  
+  /* clip to source surface */
+  if(src_x < 0)
   {
-    if((widget->w <= 0) || (*x + widget->w > window->w - window->margin))
-      *w = window->w - window->margin - *x;
-    else
-      *w = widget->w;
+    x -= src_x;
+    w += src_x;
+    src_x = 0;
+  }
+  if(src_y < 0)
+  {
+    y -= src_y;
+    h += src_y;
+    src_y = 0;
   }
+  if(src_x + w > src->w)
+    w = src->w - src_x;
+  if(src_y + h > src->h)
+    h = src->h - src_y;
   
-  if(h)
+  /* clip to destination clip rect */
+  if(x < dst->clip_rect.x)
   {
-    if((widget->h <= 0) || (*y + widget->h > window->h - window->margin))
-      *h = window->h - window->margin - *y;
-    else
-      *h = widget->h;
+    src_x += dst->clip_rect.x - x;
+    w -= dst->clip_rect.x - x;
+    x = dst->clip_rect.x;
   }
-}
-static void g_adjust_widget_position_button(const g_widget *widget, int *x, int *y, int *w, int *h)
-{
-  g_window *window = widget->window;
-  int counter, cache_w;
-  int temp_w, temp_h;
+  if(y < dst->clip_rect.y)
+  {
+    src_y += dst->clip_rect.y - y;
+    h -= dst->clip_rect.y - y;
+    y = dst->clip_rect.y;
+  }
+  if(x + w > dst->clip_rect.x + dst->clip_rect.w)
+    w = dst->clip_rect.x + dst->clip_rect.w - x;
+  if(y + h > dst->clip_rect.y + dst->clip_rect.h)
+    h = dst->clip_rect.y + dst->clip_rect.h - y;
   
-  g_adjust_widget_position(widget, x, y, NULL, NULL);
+  if(w <= 0 || h <= 0)
+    return;
   
-  /* caclucate text width and height in characters */
-  counter = 0;
-  cache_w = 1;
-  temp_w = temp_h = 1;
-  while(widget->button.text[counter] != '\0')
+  /* copy line by line; pixels in the colorkey are left out */
+  colorkey = src->format->colorkey;
+  from = (Uint8 *)src->pixels + src_y * src->pitch + src_x * src->format->BytesPerPixel;
+  to = (Uint8 *)dst->pixels + y * dst->pitch + x * dst->format->BytesPerPixel;
+  for(; h > 0; h--, from += src->pitch, to += dst->pitch)
   {
-    if((widget->button.text[counter] == '\n') || (cache_w * G_CHAR_W > window->w - G_MARGIN * 2 - window->margin * 2))
+    if(!(src->flags & SDL_SRCCOLORKEY))
+      memcpy(to, from, w * dst->format->BytesPerPixel);
+    else if(dst->format->BytesPerPixel == 2)
     {
-      cache_w = 1;
-      temp_h++;
+      for(counter = 0; counter < w; counter++)
+      {
+        if(((Uint16 *)from)[counter] != colorkey)
+          ((Uint16 *)to)[counter] = ((Uint16 *)from)[counter];
+      }
     }
     else
     {
-      if(cache_w > temp_w)
-        temp_w = cache_w;
-      cache_w++;
+      for(counter = 0; counter < w; counter++)
+      {
+        if(((Uint32 *)from)[counter] != colorkey)
+          ((Uint32 *)to)[counter] = ((Uint32 *)from)[counter];
+      }
     }
+  }
+}
+/* returns a surface containing all characters in the given color, or NULL on failure */
+static SDL_Surface *g_find_glyph_sheet(const SDL_Surface *dst, const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a)
+{
+  SDL_Surface *sheet;
+  Uint32 colorkey;
+  int counter, slot;
+  
+  /* search for an existing sheet */
+  slot = 0;
+  for(counter = 0; counter < G_GLYPH_SHEETS; counter++)
+  {
+    sheet = glyph_sheets[counter].surface;
     
-    counter++;
+    if(sheet &&
+       glyph_sheets[counter].color.r == r && glyph_sheets[counter].color.g == g &&
+       glyph_sheets[counter].color.b == b && glyph_sheets[counter].color.a == a &&
+       g_same_format(sheet->format, dst->format))
+    {
+      glyph_sheets[counter].last_use = ++glyph_sheet_uses;
+      return sheet;
+    }
+    
+    /* remember free or least recently used slot */
+    if(!sheet || (glyph_sheets[slot].surface && glyph_sheets[counter].last_use < glyph_sheets[slot].last_use))
+      slot = counter;
   }
   
-  /* calculate button width and height from text width and height */
-  *w = temp_w * G_CHAR_W + G_MARGIN * 2;
-  *h = temp_h * G_CHAR_H + G_MARGIN;
+  /* sheets used in this frame may still be in use by other threads */
+  if(render_active && glyph_sheets[slot].surface && glyph_sheets[slot].last_use > glyph_frame_uses)
+    return NULL;
   
-  /* correct position */
-  if(*x > window->w - window->margin - *w)
-    *x = window->w - window->margin - *w;
-  if(*y > window->h - window->margin - *h)
-    *y = window->h - window->margin - *h;
+  if(dst->format->BitsPerPixel < 16)
+    return NULL;
   
-  /* check if button was moved out of window while correcting position */
-  if(*x < window->margin)
-  {
-    *x = window->margin;
-    *w = window->w - window->margin * 2;
-  }
-  if(*y < window->margin)
-  {
-    *y = window->margin;
-    *h = window->h - window->margin * 2;
-  }
+  sheet = SDL_CreateRGBSurface(SDL_SWSURFACE, 256 * G_CHAR_W, G_GLYPH_H, dst->format->BitsPerPixel,
+                               dst->format->Rmask, dst->format->Gmask, dst->format->Bmask, 0);
+  if(!sheet)
+    return NULL;
+  
+  /* the inverted color can never collide with the glyph color */
+  colorkey = SDL_MapRGB(sheet->format, r ^ 0xff, g ^ 0xff, b ^ 0xff);
+  SDL_FillRect(sheet, NULL, colorkey);
+  
+  for(counter = 0; counter < 256; counter++)
+    characterRGBA(sheet, counter * G_CHAR_W, 0, counter, r, g, b, 255);
+  
+  /* SDL frees the pixels of RLE encoded sheets, which render threads need to copy glyphs without SDL */
+  if(render_thread_amount)
+    SDL_SetColorKey(sheet, SDL_SRCCOLORKEY, colorkey);
+  else
+    SDL_SetColorKey(sheet, SDL_SRCCOLORKEY | SDL_RLEACCEL, colorkey);
+  if(a != 255)
+    SDL_SetAlpha(sheet, SDL_SRCALPHA | SDL_RLEACCEL, a);
+  
+  /* replace old sheet */
+  if(glyph_sheets[slot].surface)
+    SDL_FreeSurface(glyph_sheets[slot].surface);
+  
+  glyph_sheets[slot].surface = sheet;
+  glyph_sheets[slot].color.r = r;
+  glyph_sheets[slot].color.g = g;
+  glyph_sheets[slot].color.b = b;
+  glyph_sheets[slot].color.a = a;
+  glyph_sheets[slot].last_use = ++glyph_sheet_uses;
+  
+  return sheet;
 }
-static void g_adjust_widget_position_check_box(const g_widget *widget, int *x, int *y)
+static SDL_Surface *g_get_glyph_sheet(const SDL_Surface *dst, const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a)
 {
-  g_window *window = widget->window;
+  SDL_Surface *sheet;
   
-  g_adjust_widget_position(widget, x, y, NULL, NULL);
+  g_lock_renderer();
+  sheet = g_find_glyph_sheet(dst, r, g, b, a);
+  g_unlock_renderer();
   
-  if(*x > window->w - window->margin - G_CHECK_BOX_SIZE)
-    *x = window->w - window->margin - G_CHECK_BOX_SIZE;
-  if(*y > window->h - window->margin - G_CHECK_BOX_SIZE)
-    *y = window->h - window->margin - G_CHECK_BOX_SIZE;
+  return sheet;
 }
-static void g_adjust_widget_position_surface(const g_widget *widget, int *x, int *y, int *w, int *h)
+static void g_free_glyph_sheets(void)
 {
-  g_window *window = widget->window;
+  int counter;
   
-  g_adjust_widget_position(widget, x, y, NULL, NULL);
+  for(counter = 0; counter < G_GLYPH_SHEETS; counter++)
+  {
+    if(glyph_sheets[counter].surface)
+    {
+      SDL_FreeSurface(glyph_sheets[counter].surface);
+      glyph_sheets[counter].surface = NULL;
+    }
+  }
+}
+
+/* draws a character from 'sheet', or with SDL_gfx if there is no sheet */
+static void g_draw_character(SDL_Surface *dst, SDL_Surface *sheet, const int x, const int y, const char c,
+                             const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a)
+{
+  SDL_Rect temp_src, temp_dst;
   
-  /* widget x/y + w/h cant be outside surface */
-  if((widget->w <= 0) || (widget->surface.src_x + widget->w > widget->surface.surface->w))
-    *w = widget->surface.surface->w - widget->surface.src_x;
-  else
-    *w = widget->w;
+  if(!sheet)
+  {
+    g_lock_renderer();
+    characterRGBA(dst, x, y, c, r, g, b, a);
+    g_unlock_renderer();
+    return;
+  }
   
-  if((widget->h <= 0)  || (widget->surface.src_y + widget->h > widget->surface.surface->h))
-    *h = widget->surface.surface->h - widget->surface.src_y;
-  else
-    *h = widget->h;
+  temp_src.x = (unsigned char)c * G_CHAR_W;
+  temp_src.y = 0;
+  temp_src.w = G_CHAR_W;
+  temp_src.h = G_GLYPH_H;
   
-  /* w/h cant be outside the window */
-  if(*x + *w > window->w - window->margin)
-    *w = window->w - window->margin - *x;
+  temp_dst.x = x;
+  temp_dst.y = y;
   
-  if(*y + *h > window->h - window->margin)
-    *h = window->h - window->margin - *y;
+  g_blit_surface(sheet, &temp_src, dst, &temp_dst);
 }
-static void g_adjust_widget_position_slider(const g_widget *widget, int *x, int *y, int *w, int *h)
+static void g_draw_glyph(SDL_Surface *dst, const int x, const int y, const char c,
+                         const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a)
 {
-  g_window *window = widget->window;
-  
-  g_adjust_widget_position(widget, x, y, NULL, NULL);
+  g_draw_character(dst, g_get_glyph_sheet(dst, r, g, b, a), x, y, c, r, g, b, a);
+}
+static void g_draw_string(SDL_Surface *dst, const int x, const int y, const char *text,
+                          const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a)
+{
+  SDL_Surface *sheet = g_get_glyph_sheet(dst, r, g, b, a);
+  int counter;
   
-  /* adjust x/y */
-  if(widget->type == G_TYPE_SLIDER_H)
+  for(counter = 0; text[counter] != '\0'; counter++)
+    g_draw_character(dst, sheet, x + counter * G_CHAR_W, y, text[counter], r, g, b, a);
+}
+/* blends 'color' over a row of 32 bit pixels; every channel must be 8 bits wide */
+static void g_blend_row_32(Uint32 *pixels, const int w, const Uint32 color, const Uint32 mask, const Uint8 alpha)
+{
+  Uint32 src_rb = (color & 0x00ff00ff) * alpha;
+  Uint32 src_ag = ((color >> 8) & 0x00ff00ff) * alpha;
+  Uint32 rb, ag;
+  int counter = 0;
+  
+#if defined(__AVX2__)
+  __m256i zero = _mm256_setzero_si256();
+  __m256i src = _mm256_mullo_epi16(_mm256_unpacklo_epi8(_mm256_set1_epi32(color), zero), _mm256_set1_epi16(alpha));
+  __m256i inverse = _mm256_set1_epi16(256 - alpha);
+  __m256i mask_vector = _mm256_set1_epi32(mask);
+  __m256i dst, low, high;
+  
+  for(; counter + 8 <= w; counter += 8)
   {
-    if(*y + G_SLIDER_H > window->h - window->margin)
-      *y = window->h - window->margin - G_SLIDER_H;
+    dst = _mm256_loadu_si256((__m256i *)(pixels + counter));
     
-    /* adjust widget width */
-    if(w)
+    low = _mm256_srli_epi16(_mm256_add_epi16(src, _mm256_mullo_epi16(_mm256_unpacklo_epi8(dst, zero), inverse)), 8);
+    high = _mm256_srli_epi16(_mm256_add_epi16(src, _mm256_mullo_epi16(_mm256_unpackhi_epi8(dst, zero), inverse)), 8);
+    
+    _mm256_storeu_si256((__m256i *)(pixels + counter), _mm256_and_si256(_mm256_packus_epi16(low, high), mask_vector));
+  }
+#elif defined(__SSE2__)
+  __m128i zero = _mm_setzero_si128();
+  __m128i src = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32(color), zero), _mm_set1_epi16(alpha));
+  __m128i inverse = _mm_set1_epi16(256 - alpha);
+  __m128i mask_vector = _mm_set1_epi32(mask);
+  __m128i dst, low, high;
+  
+  for(; counter + 4 <= w; counter += 4)
+  {
+    dst = _mm_loadu_si128((__m128i *)(pixels + counter));
+    
+    low = _mm_srli_epi16(_mm_add_epi16(src, _mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), inverse)), 8);
+    high = _mm_srli_epi16(_mm_add_epi16(src, _mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), inverse)), 8);
+    
+    _mm_storeu_si128((__m128i *)(pixels + counter), _mm_and_si128(_mm_packus_epi16(low, high), mask_vector));
+  }
+#endif
+  
+  /* two channels at once; src * alpha + dst * (256 - alpha) never exceeds 16 bits */
+  for(; counter < w; counter++)
+  {
+    rb = ((src_rb + (pixels[counter] & 0x00ff00ff) * (256 - alpha)) >> 8) & 0x00ff00ff;
+    ag = (src_ag + ((pixels[counter] >> 8) & 0x00ff00ff) * (256 - alpha)) & 0xff00ff00;
+    
+    pixels[counter] = (rb | ag) & mask;
+  }
+}
+/* blends 'color' over a row of 16 bit pixels */
+static void g_blend_row_16(Uint16 *pixels, const int w, const SDL_PixelFormat *format, const Uint32 color, const Uint8 alpha)
+{
+  Uint32 masks[4];
+  Uint32 src[4];
+  int shifts[4];
+  int channel, channels;
+  Uint32 pixel, result;
+  int counter = 0;
+  
+  /* prepare each channel */
+  masks[0] = format->Rmask;
+  masks[1] = format->Gmask;
+  masks[2] = format->Bmask;
+  masks[3] = format->Amask;
+  shifts[0] = format->Rshift;
+  shifts[1] = format->Gshift;
+  shifts[2] = format->Bshift;
+  shifts[3] = format->Ashift;
+  
+  channels = format->Amask ? 4 : 3;
+  for(channel = 0; channel < channels; channel++)
+  {
+    masks[channel] >>= shifts[channel];
+    src[channel] = ((color >> shifts[channel]) & masks[channel]) * alpha;
+  }
+  
+#if defined(__AVX2__)
+  {
+    __m256i inverse = _mm256_set1_epi16(256 - alpha);
+    __m256i dst, field, out;
+    
+    for(; counter + 16 <= w; counter += 16)
     {
-      if((widget->w <= 0) || (*x + widget->w > window->w - window->margin))
-        *w = window->w - window->margin - *x;
-      else
-        *w = widget->w;
+      dst = _mm256_loadu_si256((__m256i *)(pixels + counter));
+      out = _mm256_setzero_si256();
+      
+      for(channel = 0; channel < channels; channel++)
+      {
+        field = _mm256_and_si256(_mm256_srl_epi16(dst, _mm_cvtsi32_si128(shifts[channel])), _mm256_set1_epi16(masks[channel]));
+        field = _mm256_srli_epi16(_mm256_add_epi16(_mm256_set1_epi16(src[channel]), _mm256_mullo_epi16(field, inverse)), 8);
+        out = _mm256_or_si256(out, _mm256_sll_epi16(field, _mm_cvtsi32_si128(shifts[channel])));
+      }
+      
+      _mm256_storeu_si256((__m256i *)(pixels + counter), out);
     }
   }
-  else if(widget->type == G_TYPE_SLIDER_V)
+#elif defined(__SSE2__)
   {
-    if(*x + G_SLIDER_H > window->w - window->margin)
-      *x = window->w - window->margin - G_SLIDER_H;
+    __m128i inverse = _mm_set1_epi16(256 - alpha);
+    __m128i dst, field, out;
     
-    /* adjust widget height */
-    if(h)
+    for(; counter + 8 <= w; counter += 8)
     {
-      if((widget->h <= 0) || (*y + widget->h > window->h - window->margin))
-        *h = window->h - window->margin - *y;
-      else
-        *h = widget->h;
+      dst = _mm_loadu_si128((__m128i *)(pixels + counter));
+      out = _mm_setzero_si128();
+      
+      for(channel = 0; channel < channels; channel++)
+      {
+        field = _mm_and_si128(_mm_srl_epi16(dst, _mm_cvtsi32_si128(shifts[channel])), _mm_set1_epi16(masks[channel]));
+        field = _mm_srli_epi16(_mm_add_epi16(_mm_set1_epi16(src[channel]), _mm_mullo_epi16(field, inverse)), 8);
+        out = _mm_or_si128(out, _mm_sll_epi16(field, _mm_cvtsi32_si128(shifts[channel])));
+      }
+      
+      _mm_storeu_si128((__m128i *)(pixels + counter), out);
     }
   }
+#endif
+  
+  for(; counter < w; counter++)
+  {
+    pixel = pixels[counter];
+    result = 0;
+    
+    for(channel = 0; channel < channels; channel++)
+      result |= ((src[channel] + ((pixel >> shifts[channel]) & masks[channel]) * (256 - alpha)) >> 8) << shifts[channel];
+    
+    pixels[counter] = result;
+  }
 }
-static void g_adjust_widget_position_drop_down_list(const g_widget *widget, int *x, int *y, int *w)
+/* returns 1 if every channel of a 32 bit format is one whole byte */
+static int g_has_byte_channels(const SDL_PixelFormat *format)
 {
-  g_window *window = widget->window;
+  return format->BytesPerPixel == 4 &&
+         format->Rmask >> format->Rshift == 0xff && format->Gmask >> format->Gshift == 0xff &&
+         format->Bmask >> format->Bshift == 0xff && (!format->Amask || format->Amask >> format->Ashift == 0xff);
+}
+/* the cached colors are dropped, if 'format' differs from the format they were mapped to */
+static void g_set_mapped_format(const SDL_PixelFormat *format)
+{
+  if(g_same_format(&mapped_format, format) && mapped_format.Amask == format->Amask)
+    return;
   
-  g_adjust_widget_position(widget, x, y, w, NULL);
+  memset(mapped_colors, 0, sizeof(mapped_colors));
+  mapped_format = *format;
+}
+/* returns the pixel value of 'color' in the format of 'dst' */
+static Uint32 g_map_color(const SDL_Surface *dst, const struct g_color_struct *color)
+{
+  const Uint32 key = (Uint32)color->r << 24 | (Uint32)color->g << 16 | (Uint32)color->b << 8 | color->a;
+  Uint64 entry;
+  Uint32 pixel;
+  int slot;
   
-  /* correct y */
-  if(*y + G_DROP_DOWN_LIST_SIZE > window->h - window->margin)
-    *y = window->h - window->margin - G_DROP_DOWN_LIST_SIZE;
+  /* palettes can change at any time, and an empty entry equals a transparent black color */
+  if(dst->format->palette || key == 0)
+    return SDL_MapRGBA(dst->format, color->r, color->g, color->b, color->a);
+  
+  /* during parallel rendering all threads draw to the format set before, so it is not changed */
+  if(!g_same_format(&mapped_format, dst->format) || mapped_format.Amask != dst->format->Amask)
+  {
+    if(render_active)
+      return SDL_MapRGBA(dst->format, color->r, color->g, color->b, color->a);
+    
+    g_set_mapped_format(dst->format);
+  }
+  
+  /* entries are read and written as a whole, so render threads may share them */
+  /* the high bits of the product depend on all four channels */
+  slot = (Uint32)(key * 2654435761u) >> (32 - G_MAPPED_COLOR_BITS);
+  entry = __atomic_load_n(&mapped_colors[slot], __ATOMIC_RELAXED);
+  if((Uint32)(entry >> 32) == key)
+    return (Uint32)entry;
+  
+  pixel = SDL_MapRGBA(dst->format, color->r, color->g, color->b, color->a);
+  __atomic_store_n(&mapped_colors[slot], (Uint64)key << 32 | pixel, __ATOMIC_RELAXED);
+  
+  return pixel;
+}
+/* replacement for boxRGBA(); opaque boxes are filled by SDL, translucent ones blended with the kernels above */
+static void g_draw_box(SDL_Surface *dst, int x1, int y1, int x2, int y2, const struct g_color_struct *color)
+{
+  SDL_Rect rect;
+  Uint32 pixel;
+  Uint8 *row;
+  int temp;
+  
+  if(x1 > x2)
+  {
+    temp = x1;
+    x1 = x2;
+    x2 = temp;
+  }
+  if(y1 > y2)
+  {
+    temp = y1;
+    y1 = y2;
+    y2 = temp;
+  }
+  
+  if(color->a == 255)
+  {
+    rect.x = x1;
+    rect.y = y1;
+    rect.w = x2 - x1 + 1;
+    rect.h = y2 - y1 + 1;
+    
+    SDL_FillRect(dst, &rect, g_map_color(dst, color));
+    return;
+  }
+  
+  if(dst->format->BytesPerPixel != 2 && !g_has_byte_channels(dst->format))
+  {
+    boxRGBA(dst, x1, y1, x2, y2, color->r, color->g, color->b, color->a);
+    return;
+  }
+  
+  /* clip box */
+  if(x1 < dst->clip_rect.x)
+    x1 = dst->clip_rect.x;
+  if(y1 < dst->clip_rect.y)
+    y1 = dst->clip_rect.y;
+  if(x2 > dst->clip_rect.x + dst->clip_rect.w - 1)
+    x2 = dst->clip_rect.x + dst->clip_rect.w - 1;
+  if(y2 > dst->clip_rect.y + dst->clip_rect.h - 1)
+    y2 = dst->clip_rect.y + dst->clip_rect.h - 1;
+  
+  if(x1 > x2 || y1 > y2)
+    return;
+  
+  if(SDL_MUSTLOCK(dst) && SDL_LockSurface(dst) < 0)
+    return;
+  
+  pixel = g_map_color(dst, color);
+  row = (Uint8 *)dst->pixels + y1 * dst->pitch + x1 * dst->format->BytesPerPixel;
+  
+  for(; y1 <= y2; y1++, row += dst->pitch)
+  {
+    if(dst->format->BytesPerPixel == 2)
+      g_blend_row_16((Uint16 *)row, x2 - x1 + 1, dst->format, pixel, color->a);
+    else
+      g_blend_row_32((Uint32 *)row, x2 - x1 + 1, pixel,
+                     dst->format->Rmask | dst->format->Gmask | dst->format->Bmask | dst->format->Amask, color->a);
+  }
+  
+  if(SDL_MUSTLOCK(dst))
+    SDL_UnlockSurface(dst);
+}
+/* replacement for rectangleRGBA(); opaque frames are filled by SDL, translucent ones blended by SDL_gfx */
+static void g_draw_frame(SDL_Surface *dst, int x1, int y1, int x2, int y2, const struct g_color_struct *color)
+{
+  SDL_Rect line;
+  Uint32 pixel;
+  int temp;
+  
+  if(color->a != 255)
+  {
+    rectangleRGBA(dst, x1, y1, x2, y2, color->r, color->g, color->b, color->a);
+    return;
+  }
+  
+  if(x1 > x2)
+  {
+    temp = x1;
+    x1 = x2;
+    x2 = temp;
+  }
+  if(y1 > y2)
+  {
+    temp = y1;
+    y1 = y2;
+    y2 = temp;
+  }
+  
+  pixel = g_map_color(dst, color);
+  
+  /* SDL_FillRect() clips the rect, so it is set again for every line */
+  line.x = x1;
+  line.y = y1;
+  line.w = x2 - x1 + 1;
+  line.h = 1;
+  SDL_FillRect(dst, &line, pixel);
+  
+  line.x = x1;
+  line.y = y2;
+  line.w = x2 - x1 + 1;
+  line.h = 1;
+  SDL_FillRect(dst, &line, pixel);
+  
+  if(y2 - y1 < 2)
+    return;
+  
+  line.x = x1;
+  line.y = y1 + 1;
+  line.w = 1;
+  line.h = y2 - y1 - 1;
+  SDL_FillRect(dst, &line, pixel);
+  
+  line.x = x2;
+  line.y = y1 + 1;
+  line.w = 1;
+  line.h = y2 - y1 - 1;
+  SDL_FillRect(dst, &line, pixel);
+}
+static int g_same_color(const struct g_color_struct *a, const struct g_color_struct *b)
+{
+  return a->r == b->r && a->g == b->g && a->b == b->b && a->a == b->a;
+}
+/* returns a strip containing a gradient from 'top' to 'bottom', or NULL on failure */
+static SDL_Surface *g_find_gradient_strip(const SDL_Surface *dst, const int h,
+                                          const struct g_color_struct *top, const struct g_color_struct *bottom)
+{
+  SDL_Surface *strip;
+  SDL_Rect line;
+  int counter, slot;
+  float r, g, b, a;
+  float r_step, g_step, b_step, a_step;
+  
+  /* search for an existing strip */
+  slot = 0;
+  for(counter = 0; counter < G_GRADIENT_STRIPS; counter++)
+  {
+    strip = gradient_strips[counter].surface;
+    
+    if(strip && gradient_strips[counter].h == h &&
+       g_same_color(&gradient_strips[counter].top, top) &&
+       g_same_color(&gradient_strips[counter].bottom, bottom) &&
+       (strip->format->Amask || g_same_format(strip->format, dst->format)))
+    {
+      gradient_strips[counter].last_use = ++gradient_strip_uses;
+      return strip;
+    }
+    
+    /* remember free or least recently used slot */
+    if(!strip || (gradient_strips[slot].surface && gradient_strips[counter].last_use < gradient_strips[slot].last_use))
+      slot = counter;
+  }
+  
+  /* strips used in this frame may still be in use by other threads */
+  if(render_active && gradient_strips[slot].surface && gradient_strips[slot].last_use > gradient_frame_uses)
+    return NULL;
+  
+  if(dst->format->BitsPerPixel < 16)
+    return NULL;
+  
+  /* opaque gradients use the format of dst, translucent ones need an alpha channel */
+  if(top->a == 255 && bottom->a == 255)
+    strip = SDL_CreateRGBSurface(SDL_SWSURFACE, G_GRADIENT_STRIP_W, h, dst->format->BitsPerPixel,
+                                 dst->format->Rmask, dst->format->Gmask, dst->format->Bmask, 0);
   else
-    *y = widget->y;
+    strip = SDL_CreateRGBSurface(SDL_SWSURFACE, G_GRADIENT_STRIP_W, h, 32,
+                                 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
+  if(!strip)
+    return NULL;
+  
+  /* reset colors and calculate color steps */
+  r = top->r;
+  g = top->g;
+  b = top->b;
+  a = top->a;
+  
+  r_step = ((float)top->r - (float)bottom->r)/(float)h;
+  g_step = ((float)top->g - (float)bottom->g)/(float)h;
+  b_step = ((float)top->b - (float)bottom->b)/(float)h;
+  a_step = ((float)top->a - (float)bottom->a)/(float)h;
+  
+  /* fill strip */
+  line.x = 0;
+  line.w = G_GRADIENT_STRIP_W;
+  line.h = 1;
+  for(counter = 0; counter < h; counter++)
+  {
+    line.y = counter;
+    SDL_FillRect(strip, &line, SDL_MapRGBA(strip->format, (Uint8)r, (Uint8)g, (Uint8)b, (Uint8)a));
+    
+    r -= r_step;
+    g -= g_step;
+    b -= b_step;
+    a -= a_step;
+  }
+  
+  /* replace old strip */
+  if(gradient_strips[slot].surface)
+    SDL_FreeSurface(gradient_strips[slot].surface);
+  
+  gradient_strips[slot].surface = strip;
+  gradient_strips[slot].top = *top;
+  gradient_strips[slot].bottom = *bottom;
+  gradient_strips[slot].h = h;
+  gradient_strips[slot].last_use = ++gradient_strip_uses;
+  
+  return strip;
 }
-static void g_adjust_widget_position_drop_down_list_size(const g_widget *widget, int *x, int *y, int *w, int *h)
+static SDL_Surface *g_get_gradient_strip(const SDL_Surface *dst, const int h,
+                                         const struct g_color_struct *top, const struct g_color_struct *bottom)
 {
-  g_window *window = widget->window;
-  SDL_Surface *dst = SDL_GetVideoSurface();
-  int counter, cache_w;
-  int temp_x, temp_y;
-  int temp_w, temp_h;
+  SDL_Surface *strip;
   
-  /* caclucate text width and height in characters */
-  counter = 0;
-  cache_w = 1;
-  temp_w = temp_h = 1;
-  while(widget->button.text[counter] != '\0')
+  g_lock_renderer();
+  strip = g_find_gradient_strip(dst, h, top, bottom);
+  g_unlock_renderer();
+  
+  return strip;
+}
+static void g_free_gradient_strips(void)
+{
+  int counter;
+  
+  for(counter = 0; counter < G_GRADIENT_STRIPS; counter++)
   {
-    if(widget->button.text[counter] == '\n')
+    if(gradient_strips[counter].surface)
     {
-      cache_w = 1;
-      temp_h++;
+      SDL_FreeSurface(gradient_strips[counter].surface);
+      gradient_strips[counter].surface = NULL;
+    }
+  }
+}
+
+/* draws the first 'lines' lines of a gradient from 'top' to 'bottom' with the height 'h' */
+static void g_draw_gradient(SDL_Surface *dst, const int x, const int y, const int w, const int h, const int lines,
+                            const struct g_color_struct *top, const struct g_color_struct *bottom)
+{
+  SDL_Surface *strip;
+  SDL_Rect temp_src, temp_dst;
+  int counter;
+  float r, g, b, a;
+  float r_step, g_step, b_step, a_step;
+  
+  if(w <= 0 || h <= 0)
+    return;
+  
+  /* blit strip repeatedly until the whole width is covered */
+  strip = g_get_gradient_strip(dst, h, top, bottom);
+  if(strip)
+  {
+    for(counter = 0; counter < w; counter += G_GRADIENT_STRIP_W)
+    {
+      temp_src.x = 0;
+      temp_src.y = 0;
+      temp_src.w = w - counter < G_GRADIENT_STRIP_W ? w - counter : G_GRADIENT_STRIP_W;
+      temp_src.h = lines;
+      
+      temp_dst.x = x + counter;
+      temp_dst.y = y;
+      
+      g_blit_surface(strip, &temp_src, dst, &temp_dst);
+    }
+    
+    return;
+  }
+  
+  /* reset colors and calculate color steps */
+  r = top->r;
+  g = top->g;
+  b = top->b;
+  a = top->a;
+  
+  r_step = ((float)top->r - (float)bottom->r)/(float)h;
+  g_step = ((float)top->g - (float)bottom->g)/(float)h;
+  b_step = ((float)top->b - (float)bottom->b)/(float)h;
+  a_step = ((float)top->a - (float)bottom->a)/(float)h;
+  
+  /* draw gradient line by line */
+  for(counter = y; counter < y + lines; counter++)
+  {
+    hlineRGBA(dst, x, x + w - 1, counter, r, g, b, a);
+    
+    r -= r_step;
+    g -= g_step;
+    b -= b_step;
+    a -= a_step;
+  }
+}
+static void g_draw_text(SDL_Surface *dst, const char *text,
+                        const int x, const int y, const int w, const int h,
+                        const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a)
+{
+  SDL_Surface *sheet = g_get_glyph_sheet(dst, r, g, b, a);
+  int dest_x, dest_y;
+  int counter;
+  
+  /* draw text loop */
+  dest_x = x;
+  dest_y = y;
+  for(counter = 0; text[counter] != '\0' && dest_y < y + h; counter++)
+  {
+    if(text[counter] != '\n')
+      g_draw_character(dst, sheet, dest_x, dest_y, text[counter], r, g, b, a);
+    
+    if(dest_x + G_CHAR_W < x + w && text[counter] != '\n')
+    {
+      dest_x += G_CHAR_W;
     }
     else
     {
-      if(cache_w > temp_w)
-        temp_w = cache_w;
-      cache_w++;
+      dest_x = x;
+      dest_y += G_CHAR_H;
     }
+  }
+}
+static int g_rect_intersects(const SDL_Rect *rect, const int x, const int y, const int w, const int h)
+{
+  return x < rect->x + rect->w && x + w > rect->x &&
+         y < rect->y + rect->h && y + h > rect->y;
+}
+/* stores the intersection of 'a' and 'b' in 'result'; returns 0 if they dont intersect */
+static int g_intersect_rect(const SDL_Rect *a, const SDL_Rect *b, SDL_Rect *result)
+{
+  int x1, y1, x2, y2;
+  
+  x1 = (a->x > b->x) ? a->x : b->x;
+  y1 = (a->y > b->y) ? a->y : b->y;
+  x2 = (a->x + a->w < b->x + b->w) ? a->x + a->w : b->x + b->w;
+  y2 = (a->y + a->h < b->y + b->h) ? a->y + a->h : b->y + b->h;
+  
+  if(x1 >= x2 || y1 >= y2)
+    return 0;
+  
+  result->x = x1;
+  result->y = y1;
+  result->w = x2 - x1;
+  result->h = y2 - y1;
+  
+  return 1;
+}
+static void g_damage_rect(int x, int y, int w, int h)
+{
+  SDL_Rect *rect;
+  int counter, best;
+  int growth, best_growth;
+  int x1, y1, x2, y2;
+  
+  /* regions left or above the video surface are cut off */
+  if(x < 0)
+  {
+    w += x;
+    x = 0;
+  }
+  if(y < 0)
+  {
+    h += y;
+    y = 0;
+  }
+  
+  if(w <= 0 || h <= 0 || damage_everything)
+    return;
+  
+  /* search for a region touching the new one */
+  for(best = 0; best < damage_rect_amount; best++)
+  {
+    rect = &damage_rects[best];
     
-    counter++;
+    if(x <= rect->x + rect->w && x + w >= rect->x &&
+       y <= rect->y + rect->h && y + h >= rect->y)
+      break;
   }
   
-  /* calculate box width and height from text width and height */
-  *w = temp_w * G_CHAR_W + G_MARGIN * 2;
-  *h = temp_h * G_CHAR_H;
+  if(best == damage_rect_amount)
+  {
+    /* store new region */
+    if(damage_rect_amount < G_MAX_DAMAGE_RECTS)
+    {
+      damage_rects[damage_rect_amount].x = x;
+      damage_rects[damage_rect_amount].y = y;
+      damage_rects[damage_rect_amount].w = w;
+      damage_rects[damage_rect_amount].h = h;
+      damage_rect_amount++;
+      
+      return;
+    }
+    
+    /* no free slot left, so merge with the region which grows least */
+    best = 0;
+    best_growth = -1;
+    for(counter = 0; counter < damage_rect_amount; counter++)
+    {
+      rect = &damage_rects[counter];
+      
+      x1 = (rect->x < x) ? rect->x : x;
+      y1 = (rect->y < y) ? rect->y : y;
+      x2 = (rect->x + rect->w > x + w) ? rect->x + rect->w : x + w;
+      y2 = (rect->y + rect->h > y + h) ? rect->y + rect->h : y + h;
+      growth = (x2 - x1) * (y2 - y1) - rect->w * rect->h;
+      
+      if(best_growth < 0 || growth < best_growth)
+      {
+        best = counter;
+        best_growth = growth;
+      }
+    }
+  }
   
-  /* set x/y */
-  g_adjust_widget_position_drop_down_list(widget, &temp_x, &temp_y, &temp_w);
-  if(*w < temp_w)
-    *w = temp_w;
+  /* merge regions */
+  rect = &damage_rects[best];
   
-  if(window->x + temp_x < 1)
-    *x = 1;
-  else if(window->x + temp_x + *w > dst->w)
-    *x = dst->w - *w - 1;
-  else
-    *x = window->x + temp_x;
+  x1 = (rect->x < x) ? rect->x : x;
+  y1 = (rect->y < y) ? rect->y : y;
+  x2 = (rect->x + rect->w > x + w) ? rect->x + rect->w : x + w;
+  y2 = (rect->y + rect->h > y + h) ? rect->y + rect->h : y + h;
   
-  if(window->y + temp_y + G_DROP_DOWN_LIST_SIZE + *h > dst->h)
+  rect->x = x1;
+  rect->y = y1;
+  rect->w = x2 - x1;
+  rect->h = y2 - y1;
+}
+static void g_get_window_area(const g_window *window, int *x, int *y, int *w, int *h)
+{
+  /* window body, frame and title bar */
+  *x = window->x - 1;
+  *w = window->w + 2;
+  
+  if(window->flags.title_bar)
+  {
+    *y = window->y - G_WINDOW_TITLE_BAR_HEIGHT - 1;
+    *h = window->h + G_WINDOW_TITLE_BAR_HEIGHT + 2;
+  }
+  else
+  {
+    *y = window->y - 1;
+    *h = window->h + 2;
+  }
+}
+/* forgets the remembered hover widget; called whenever windows or widgets change */
+static void g_forget_hover(void)
+{
+  hover.window = NULL;
+  hover.changes++;
+}
+/* damages the area of the window without invalidating its cache; used for moving/raising windows */
+static void g_damage_window_area(const g_window *window)
+{
+  int x, y, w, h;
+  
+  /* the window has moved, changed or has been raised */
+  g_forget_hover();
+  
+  if(!window->flags.visible)
+    return;
+  
+  g_get_window_area(window, &x, &y, &w, &h);
+  g_damage_rect(x, y, w, h);
+}
+static void g_mark_window_as_selected_pop_up(g_window *window, const Uint32 delay)
+{
+  selected_pop_up_window = window;
+  selected_pop_up_timestop = SDL_GetTicks();
+  selected_pop_up_delay = delay;
+}
+static void g_update_pop_up(void)
+{
+  /* activate pop_up window */
+  if(selected_pop_up_window && !selected_pop_up_window->flags.visible &&
+     SDL_GetTicks() - selected_pop_up_timestop > selected_pop_up_delay)
+    g_open_pop_up(selected_pop_up_window);
+}
+
+/* returns adjustet position in window, not on video surface */
+static void g_adjust_widget_position(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_window *window = widget->window;
+  
+  /* widget position in window cant be smaller than window->margin */
+  if(widget->x < window->margin)
+    *x = window->margin;
+  else
+    *x = widget->x;
+  
+  if(widget->y < window->margin)
+    *y = window->margin;
+  else
+    *y = widget->y;
+  
+  /* widget cant be bigger then window */
+  if(w)
+  {
+    if((widget->w <= 0) || (*x + widget->w > window->w - window->margin))
+      *w = window->w - window->margin - *x;
+    else
+      *w = widget->w;
+  }
+  
+  if(h)
+  {
+    if((widget->h <= 0) || (*y + widget->h > window->h - window->margin))
+      *h = window->h - window->margin - *y;
+    else
+      *h = widget->h;
+  }
+}
+static void g_adjust_widget_position_button(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  /* the layout is a cache, so it may change even if the widget is const */
+  struct g_widget_layout *layout = (struct g_widget_layout *)&widget->layout;
+  g_window *window = widget->window;
+  int counter, cache_w;
+  int temp_w, temp_h;
+  
+  /* use cached layout, if nothing has changed */
+  if(layout->valid &&
+     layout->widget_x == widget->x && layout->widget_y == widget->y &&
+     layout->window_w == window->w && layout->window_h == window->h &&
+     layout->window_margin == window->margin)
+  {
+    *x = layout->x;
+    *y = layout->y;
+    *w = layout->w;
+    *h = layout->h;
+    return;
+  }
+  
+  g_adjust_widget_position(widget, x, y, NULL, NULL);
+  
+  /* caclucate text width and height in characters */
+  counter = 0;
+  cache_w = 1;
+  temp_w = temp_h = 1;
+  while(widget->button.text[counter] != '\0')
+  {
+    if((widget->button.text[counter] == '\n') || (cache_w * G_CHAR_W > window->w - G_MARGIN * 2 - window->margin * 2))
+    {
+      cache_w = 1;
+      temp_h++;
+    }
+    else
+    {
+      if(cache_w > temp_w)
+        temp_w = cache_w;
+      cache_w++;
+    }
+    
+    counter++;
+  }
+  
+  /* calculate button width and height from text width and height */
+  *w = temp_w * G_CHAR_W + G_MARGIN * 2;
+  *h = temp_h * G_CHAR_H + G_MARGIN;
+  
+  /* correct position */
+  if(*x > window->w - window->margin - *w)
+    *x = window->w - window->margin - *w;
+  if(*y > window->h - window->margin - *h)
+    *y = window->h - window->margin - *h;
+  
+  /* check if button was moved out of window while correcting position */
+  if(*x < window->margin)
+  {
+    *x = window->margin;
+    *w = window->w - window->margin * 2;
+  }
+  if(*y < window->margin)
+  {
+    *y = window->margin;
+    *h = window->h - window->margin * 2;
+  }
+  
+  /* store layout */
+  layout->widget_x = widget->x;
+  layout->widget_y = widget->y;
+  layout->window_w = window->w;
+  layout->window_h = window->h;
+  layout->window_margin = window->margin;
+  layout->x = *x;
+  layout->y = *y;
+  layout->w = *w;
+  layout->h = *h;
+  layout->valid = 1;
+}
+static void g_adjust_widget_position_check_box(const g_widget *widget, int *x, int *y)
+{
+  g_window *window = widget->window;
+  
+  g_adjust_widget_position(widget, x, y, NULL, NULL);
+  
+  if(*x > window->w - window->margin - G_CHECK_BOX_SIZE)
+    *x = window->w - window->margin - G_CHECK_BOX_SIZE;
+  if(*y > window->h - window->margin - G_CHECK_BOX_SIZE)
+    *y = window->h - window->margin - G_CHECK_BOX_SIZE;
+}
+static void g_adjust_widget_position_surface(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_window *window = widget->window;
+  
+  g_adjust_widget_position(widget, x, y, NULL, NULL);
+  
+  /* widget x/y + w/h cant be outside surface */
+  if((widget->w <= 0) || (widget->surface.src_x + widget->w > widget->surface.surface->w))
+    *w = widget->surface.surface->w - widget->surface.src_x;
+  else
+    *w = widget->w;
+  
+  if((widget->h <= 0)  || (widget->surface.src_y + widget->h > widget->surface.surface->h))
+    *h = widget->surface.surface->h - widget->surface.src_y;
+  else
+    *h = widget->h;
+  
+  /* w/h cant be outside the window */
+  if(*x + *w > window->w - window->margin)
+    *w = window->w - window->margin - *x;
+  
+  if(*y + *h > window->h - window->margin)
+    *h = window->h - window->margin - *y;
+}
+static void g_adjust_widget_position_slider(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_window *window = widget->window;
+  
+  g_adjust_widget_position(widget, x, y, NULL, NULL);
+  
+  /* adjust x/y */
+  if(widget->type == G_TYPE_SLIDER_H)
+  {
+    if(*y + G_SLIDER_H > window->h - window->margin)
+      *y = window->h - window->margin - G_SLIDER_H;
+    
+    /* adjust widget width */
+    if(w)
+    {
+      if((widget->w <= 0) || (*x + widget->w > window->w - window->margin))
+        *w = window->w - window->margin - *x;
+      else
+        *w = widget->w;
+    }
+  }
+  else if(widget->type == G_TYPE_SLIDER_V)
+  {
+    if(*x + G_SLIDER_H > window->w - window->margin)
+      *x = window->w - window->margin - G_SLIDER_H;
+    
+    /* adjust widget height */
+    if(h)
+    {
+      if((widget->h <= 0) || (*y + widget->h > window->h - window->margin))
+        *h = window->h - window->margin - *y;
+      else
+        *h = widget->h;
+    }
+  }
+}
+static void g_adjust_widget_position_drop_down_list(const g_widget *widget, int *x, int *y, int *w)
+{
+  g_window *window = widget->window;
+  
+  g_adjust_widget_position(widget, x, y, w, NULL);
+  
+  /* correct y */
+  if(*y + G_DROP_DOWN_LIST_SIZE > window->h - window->margin)
+    *y = window->h - window->margin - G_DROP_DOWN_LIST_SIZE;
+  else
+    *y = widget->y;
+}
+static void g_adjust_widget_position_drop_down_list_size(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_window *window = widget->window;
+  SDL_Surface *dst = SDL_GetVideoSurface();
+  int temp_x, temp_y;
+  int temp_w, temp_h;
+  
+  /* text width and height in characters */
+  temp_w = widget->drop_down.max_length;
+  temp_h = widget->drop_down.max_item + 1;
+  
+  /* calculate box width and height from text width and height */
+  *w = temp_w * G_CHAR_W + G_MARGIN * 2;
+  *h = temp_h * G_CHAR_H;
+  
+  /* set x/y */
+  g_adjust_widget_position_drop_down_list(widget, &temp_x, &temp_y, &temp_w);
+  if(*w < temp_w)
+    *w = temp_w;
+  
+  if(window->x + temp_x < 1)
+    *x = 1;
+  else if(window->x + temp_x + *w > dst->w)
+    *x = dst->w - *w - 1;
+  else
+    *x = window->x + temp_x;
+  
+  if(window->y + temp_y + G_DROP_DOWN_LIST_SIZE + *h > dst->h)
     *y = window->y + temp_y - *h - 1;
   else
     *y = window->y + temp_y + G_DROP_DOWN_LIST_SIZE + 1;
 }
-
-/* widget draw functions */
-static void g_draw_widget_text(SDL_Surface *dst, const g_widget *widget)
+
+/* widget area functions */
+/* they return the area in the window, which the widget draws to, including frames and text overhang */
+static void g_get_widget_area_text(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position(widget, x, y, w, h);
+  *h += G_CHAR_H;
+}
+static void g_get_widget_area_input_box(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position(widget, x, y, w, h);
+  *w += 1;
+  *h += G_CHAR_H;
+}
+static void g_get_widget_area_button(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position_button(widget, x, y, w, h);
+  *x -= 1;
+  *y -= 1;
+  *w += 2;
+  *h += 2;
+}
+static void g_get_widget_area_check_box(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position_check_box(widget, x, y);
+  *w = G_CHECK_BOX_SIZE + 1;
+  *h = G_CHECK_BOX_SIZE + 1;
+}
+static void g_get_widget_area_surface(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position_surface(widget, x, y, w, h);
+}
+static void g_get_widget_area_slider_h(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position_slider(widget, x, y, w, NULL);
+  *x -= 1;
+  *y -= 1;
+  *w += 2;
+  *h = G_SLIDER_H + 2;
+}
+static void g_get_widget_area_slider_v(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position_slider(widget, x, y, NULL, h);
+  *x -= 1;
+  *y -= 1;
+  *w = G_SLIDER_H + 2;
+  *h += 2;
+}
+static void g_get_widget_area_drop_down_list(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position_drop_down_list(widget, x, y, w);
+  *x -= 1;
+  *y -= 1;
+  *w += 2;
+  *h = G_DROP_DOWN_LIST_SIZE + 2;
+}
+
+/* widget hit area functions */
+/* they return the area in the window, which reacts to the mouse */
+static int g_get_widget_hit_area_text(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position(widget, x, y, w, h);
+  return 1;
+}
+static int g_get_widget_hit_area_button(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position_button(widget, x, y, w, h);
+  return 1;
+}
+static int g_get_widget_hit_area_check_box(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position_check_box(widget, x, y);
+  *w = G_CHECK_BOX_SIZE;
+  *h = G_CHECK_BOX_SIZE;
+  return 1;
+}
+static int g_get_widget_hit_area_surface(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position_surface(widget, x, y, w, h);
+  return 1;
+}
+static int g_get_widget_hit_area_slider_h(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position_slider(widget, x, y, w, NULL);
+  *h = G_SLIDER_H;
+  return 1;
+}
+static int g_get_widget_hit_area_slider_v(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position_slider(widget, x, y, NULL, h);
+  *w = G_SLIDER_H;
+  return 1;
+}
+static int g_get_widget_hit_area_drop_down_list(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  g_adjust_widget_position_drop_down_list(widget, x, y, w);
+  *h = G_DROP_DOWN_LIST_SIZE;
+  return 1;
+}
+
+/* returns the area in the window, which the widget draws to */
+static void g_get_widget_area(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  /* widgets without a class draw nothing, so they have an empty area */
+  if((int)widget->type >= widget_type_amount || !widget_classes[widget->type].get_area)
+  {
+    *x = 0;
+    *y = 0;
+    *w = 0;
+    *h = 0;
+    return;
+  }
+  
+  widget_classes[widget->type].get_area(widget, x, y, w, h);
+}
+
+/* returns the area in the window, which reacts to the mouse; returns 0 if the widget can not be hit */
+static int g_get_widget_hit_area(const g_widget *widget, int *x, int *y, int *w, int *h)
+{
+  if(!widget_classes[widget->type].get_hit_area)
+    return 0;
+  
+  return widget_classes[widget->type].get_hit_area(widget, x, y, w, h);
+}
+
+/* hit grid functions */
+static void g_free_hit_grid(g_window *window)
+{
+  free(window->hit_grid.cells);
+  free(window->hit_grid.entries);
+  free(window->hit_grid.widgets);
+  free(window->hit_grid.areas);
+  free(window->hit_grid.hit_areas);
+  
+  window->hit_grid.cells = NULL;
+  window->hit_grid.entries = NULL;
+  window->hit_grid.widgets = NULL;
+  window->hit_grid.areas = NULL;
+  window->hit_grid.hit_areas = NULL;
+  window->hit_grid.widget_amount = 0;
+  window->hit_grid.valid = 0;
+}
+
+/* converts the area of a widget into a range of grid cells; returns 0 if the widget can not be hit */
+static int g_get_hit_grid_range(const g_window *window, const struct g_widget_rect *area, const struct g_widget_rect *hit_area,
+                                int *x1, int *y1, int *x2, int *y2)
+{
+  int x = area->x, y = area->y, w = area->w, h = area->h;
+  
+  if(hit_area->w <= 0)
+    return 0;
+  
+  /* mouse events are only checked inside the window */
+  if(x < 0)
+  {
+    w += x;
+    x = 0;
+  }
+  if(y < 0)
+  {
+    h += y;
+    y = 0;
+  }
+  if(x + w > window->w)
+    w = window->w - x;
+  if(y + h > window->h)
+    h = window->h - y;
+  
+  if(w <= 0 || h <= 0)
+    return 0;
+  
+  *x1 = x/G_HIT_GRID_CELL_SIZE;
+  *y1 = y/G_HIT_GRID_CELL_SIZE;
+  *x2 = (x + w - 1)/G_HIT_GRID_CELL_SIZE;
+  *y2 = (y + h - 1)/G_HIT_GRID_CELL_SIZE;
+  
+  return 1;
+}
+
+/* stores the area and the hit area of a widget, like they are kept in the grid */
+static void g_get_widget_rects(const g_window *window, const g_widget *widget,
+                               struct g_widget_rect *area, struct g_widget_rect *hit_area)
+{
+  g_get_widget_area(widget, &area->x, &area->y, &area->w, &area->h);
+  
+  /* widgets outside the window w/h range and widgets without hit area get an empty hit area */
+  if((widget->x > window->w - window->margin) || (widget->y > window->h - window->margin) ||
+     !g_get_widget_hit_area(widget, &hit_area->x, &hit_area->y, &hit_area->w, &hit_area->h))
+  {
+    hit_area->x = 0;
+    hit_area->y = 0;
+    hit_area->w = 0;
+    hit_area->h = 0;
+  }
+}
+/* stores the areas of all widgets in the packed arrays of the grid */
+static int g_build_widget_areas(g_window *window)
+{
+  struct g_hit_grid *grid = &window->hit_grid;
+  g_widget *widget;
+  int amount = 0;
+  
+  for(widget = window->first_widget; widget; widget = widget->next)
+    amount++;
+  
+  grid->widgets = malloc((amount + 1) * sizeof(g_widget *));
+  grid->areas = malloc((amount + 1) * sizeof(struct g_widget_rect));
+  grid->hit_areas = malloc((amount + 1) * sizeof(struct g_widget_rect));
+  if(!grid->widgets || !grid->areas || !grid->hit_areas)
+    return 0;
+  
+  for(widget = window->first_widget, amount = 0; widget; widget = widget->next, amount++)
+  {
+    grid->widgets[amount] = widget;
+    g_get_widget_rects(window, widget, &grid->areas[amount], &grid->hit_areas[amount]);
+  }
+  
+  grid->widget_amount = amount;
+  
+  return 1;
+}
+
+static int g_build_hit_grid(g_window *window)
+{
+  struct g_hit_grid *grid = &window->hit_grid;
+  int x1, y1, x2, y2;
+  int column, row;
+  int cell_amount, amount, size;
+  int counter;
+  
+  g_free_hit_grid(window);
+  
+  if(!g_build_widget_areas(window))
+  {
+    g_free_hit_grid(window);
+    return 0;
+  }
+  
+  grid->columns = (window->w + G_HIT_GRID_CELL_SIZE - 1)/G_HIT_GRID_CELL_SIZE;
+  grid->rows = (window->h + G_HIT_GRID_CELL_SIZE - 1)/G_HIT_GRID_CELL_SIZE;
+  cell_amount = grid->columns * grid->rows;
+  
+  if(cell_amount <= 0)
+  {
+    g_free_hit_grid(window);
+    return 0;
+  }
+  
+  grid->cells = calloc(cell_amount, sizeof(int));
+  if(!grid->cells)
+  {
+    g_free_hit_grid(window);
+    return 0;
+  }
+  
+  /* count the widgets touching every cell */
+  for(counter = 0; counter < grid->widget_amount; counter++)
+  {
+    if(!g_get_hit_grid_range(window, &grid->areas[counter], &grid->hit_areas[counter], &x1, &y1, &x2, &y2))
+      continue;
+    
+    for(row = y1; row <= y2; row++)
+      for(column = x1; column <= x2; column++)
+        grid->cells[row * grid->columns + column]++;
+  }
+  
+  /* let every cell point behind its list; one entry stays -1 to terminate the list */
+  amount = 0;
+  for(counter = 0; counter < cell_amount; counter++)
+  {
+    size = grid->cells[counter];
+    amount += size;
+    grid->cells[counter] = amount;
+    amount++;
+  }
+  
+  grid->entries = malloc(amount * sizeof(int));
+  if(!grid->entries)
+  {
+    g_free_hit_grid(window);
+    return 0;
+  }
+  
+  for(counter = 0; counter < amount; counter++)
+    grid->entries[counter] = -1;
+  
+  /* fill the lists from back to front, so the topmost widget comes first */
+  for(counter = 0; counter < grid->widget_amount; counter++)
+  {
+    if(!g_get_hit_grid_range(window, &grid->areas[counter], &grid->hit_areas[counter], &x1, &y1, &x2, &y2))
+      continue;
+    
+    for(row = y1; row <= y2; row++)
+      for(column = x1; column <= x2; column++)
+        grid->entries[--grid->cells[row * grid->columns + column]] = counter;
+  }
+  
+  grid->window_w = window->w;
+  grid->window_h = window->h;
+  grid->window_margin = window->margin;
+  grid->valid = 1;
+  
+  return 1;
+}
+
+/* returns 1 if the grid and the widget areas match the current window */
+static int g_hit_grid_is_current(const g_window *window)
+{
+  const struct g_hit_grid *grid = &window->hit_grid;
+  
+  return grid->valid &&
+         grid->window_w == window->w &&
+         grid->window_h == window->h &&
+         grid->window_margin == window->margin;
+}
+
+/* rebuilds the grid if the window has changed; returns 0 if it is not available */
+static int g_update_hit_grid(g_window *window)
+{
+  if(g_hit_grid_is_current(window))
+    return 1;
+  
+  return g_build_hit_grid(window);
+}
+
+/* returns 1 if the grid still matches the areas of a damaged widget */
+static int g_hit_grid_matches_widget(const g_window *window, const g_widget *widget)
+{
+  const struct g_hit_grid *grid = &window->hit_grid;
+  struct g_widget_rect area, hit_area;
+  int counter;
+  
+  if(!g_hit_grid_is_current(window))
+    return 0;
+  
+  for(counter = 0; counter < grid->widget_amount; counter++)
+    if(grid->widgets[counter] == widget)
+      break;
+  
+  if(counter == grid->widget_amount)
+    return 0;
+  
+  g_get_widget_rects(window, widget, &area, &hit_area);
+  
+  return !memcmp(&area, &grid->areas[counter], sizeof(area)) &&
+         !memcmp(&hit_area, &grid->hit_areas[counter], sizeof(hit_area));
+}
+/* returns the list of widget indices terminated by -1, which may be hit at x/y inside the window */
+/* returns NULL if the grid is not available; all widgets must be checked in this case */
+static int *g_get_hit_grid_cell(g_window *window, const int x, const int y)
+{
+  struct g_hit_grid *grid = &window->hit_grid;
+  
+  if(!g_update_hit_grid(window))
+    return NULL;
+  
+  if(x < 0 || y < 0 || x >= window->w || y >= window->h)
+    return NULL;
+  
+  return &grid->entries[grid->cells[(y/G_HIT_GRID_CELL_SIZE) * grid->columns + x/G_HIT_GRID_CELL_SIZE]];
+}
+
+/* returns the topmost widget, whose hit area contains x/y inside the window, and stores its hit area */
+/* only the widgets in 'cell' are checked, or all widgets if it is NULL. 'index' is set to the index */
+/* of the widget in the grid, or -1 */
+static g_widget *g_find_widget(g_window *window, const int *cell, const int x, const int y,
+                               struct g_widget_rect *hit_area, int *index)
+{
+  const struct g_hit_grid *grid = &window->hit_grid;
+  const struct g_widget_rect *area;
+  g_widget *widget;
+  
+  *index = -1;
+  
+  if(cell)
+  {
+    for(; *cell >= 0; cell++)
+    {
+      area = &grid->hit_areas[*cell];
+      
+      if(x > area->x && x < area->x + area->w &&
+         y > area->y && y < area->y + area->h)
+      {
+        widget = grid->widgets[*cell];
+        
+        /* the list of the active drop down list has been checked already */
+        if(widget == active_drop_down_list)
+          continue;
+        
+        *hit_area = *area;
+        *index = *cell;
+        
+        return widget;
+      }
+    }
+    
+    return NULL;
+  }
+  
+  for(widget = window->last_widget; widget; widget = widget->prev)
+  {
+    /* continue if widget is not in window w/h range */
+    if((widget->x > window->w - window->margin) || (widget->y > window->h - window->margin))
+      continue;
+    
+    if(widget == active_drop_down_list)
+      continue;
+    
+    if(!g_get_widget_hit_area(widget, &hit_area->x, &hit_area->y, &hit_area->w, &hit_area->h))
+      continue;
+    
+    if(x > hit_area->x && x < hit_area->x + hit_area->w &&
+       y > hit_area->y && y < hit_area->y + hit_area->h)
+      return widget;
+  }
+  
+  return NULL;
+}
+
+/* remembers the widget with the grid index 'index', which has been hit by the mouse at x/y, */
+/* or the window if index is -1. cell is the grid cell, which was checked; the remembered area */
+/* is limited to this cell */
+static void g_remember_hover(g_window *window, const int *cell, const int index, const int x, const int y)
+{
+  const struct g_widget_rect *area;
+  g_window *other;
+  int x1, y1, x2, y2;
+  int wx, wy, ww, wh;
+  
+  g_forget_hover();
+  
+  /* start with the cell in window coordinates, without the window frame */
+  x1 = (x - window->x)/G_HIT_GRID_CELL_SIZE * G_HIT_GRID_CELL_SIZE;
+  y1 = (y - window->y)/G_HIT_GRID_CELL_SIZE * G_HIT_GRID_CELL_SIZE;
+  x2 = x1 + G_HIT_GRID_CELL_SIZE - 1;
+  y2 = y1 + G_HIT_GRID_CELL_SIZE - 1;
+  
+  if(x1 < 1)
+    x1 = 1;
+  if(y1 < 1)
+    y1 = 1;
+  if(x2 > window->w - 1)
+    x2 = window->w - 1;
+  if(y2 > window->h - 1)
+    y2 = window->h - 1;
+  
+  /* the mouse must stay inside the widget */
+  if(index >= 0)
+  {
+    area = &window->hit_grid.hit_areas[index];
+    
+    if(x1 < area->x + 1)
+      x1 = area->x + 1;
+    if(y1 < area->y + 1)
+      y1 = area->y + 1;
+    if(x2 > area->x + area->w - 1)
+      x2 = area->x + area->w - 1;
+    if(y2 > area->y + area->h - 1)
+      y2 = area->y + area->h - 1;
+  }
+  
+  if(x1 > x2 || y1 > y2)
+    return;
+  
+  /* the resize mark is checked before the widgets */
+  if(window->flags.resizable && x2 > window->w - G_MARGIN && y2 > window->h - G_MARGIN)
+    return;
+  
+  /* widgets above the hit widget must not reach into the area */
+  for(; *cell >= 0 && *cell != index; cell++)
+  {
+    area = &window->hit_grid.hit_areas[*cell];
+    
+    if(area->w <= 0)
+      continue;
+    
+    if(x1 < area->x + area->w && x2 > area->x && y1 < area->y + area->h && y2 > area->y)
+      return;
+  }
+  
+  /* convert to screen coordinates */
+  x1 += window->x;
+  y1 += window->y;
+  x2 += window->x;
+  y2 += window->y;
+  
+  /* windows above must not cover the area */
+  for(other = window->next; other; other = other->next)
+  {
+    if(!other->flags.visible)
+      continue;
+    
+    g_get_window_area(other, &wx, &wy, &ww, &wh);
+    
+    if(x1 < wx + ww && x2 >= wx && y1 < wy + wh && y2 >= wy)
+      return;
+  }
+  
+  hover.window = window;
+  hover.entries[0] = index;
+  hover.entries[1] = -1;
+  hover.x1 = x1;
+  hover.y1 = y1;
+  hover.x2 = x2;
+  hover.y2 = y2;
+}
+
+/* theme functions */
+static const g_theme *g_get_window_theme(const g_window *window)
+{
+  if(window->theme)
+    return window->theme;
+  
+  return default_theme;
+}
+static const struct g_window_colors *g_get_window_colors(const g_window *window)
+{
+  if(window->color)
+    return window->color;
+  
+  if(window->is_pop_up)
+    return &g_get_window_theme(window)->pop_up;
+  
+  return &g_get_window_theme(window)->window;
+}
+const g_theme *g_get_widget_theme(const g_widget *widget)
+{
+  if(widget->theme)
+    return widget->theme;
+  
+  return g_get_window_theme(widget->window);
+}
+
+/* widget draw functions */
+static void g_draw_widget_text(SDL_Surface *dst, const g_widget *widget, const int window_x, const int window_y)
+{
+  const struct g_text_colors *color = widget->text.color ? widget->text.color : &g_get_widget_theme(widget)->text;
+  int x, y, w, h;
+  
+  g_adjust_widget_position(widget, &x, &y, &w, &h);
+  
+  /* draw widget text */
+  g_draw_text(dst, widget->text.text, window_x + x, window_y + y, w, h,
+              color->text.r, color->text.g,
+              color->text.b, color->text.a);
+}
+static void g_draw_widget_input_box(SDL_Surface *dst, const g_widget *widget, const int window_x, const int window_y)
+{
+  const struct g_input_box_colors *color = widget->input.color ? widget->input.color : &g_get_widget_theme(widget)->input;
+  SDL_Surface *sheet;
+  int x, y, w, h;
+  int dest_x, dest_y;
+  int counter;
+  int text_length;
+  
+  g_adjust_widget_position(widget, &x, &y, &w, &h);
+  
+  /* draw background */
+  if(widget == active_input_box)
+  {
+    g_draw_box(dst, window_x + x + 1, window_y + y + 1,
+               window_x + x + w - 1, window_y + y + h - 1, &color->background_active);
+  }
+  else
+  {
+    g_draw_box(dst, window_x + x + 1, window_y + y + 1,
+               window_x + x + w - 1, window_y + y + h - 1, &color->background);
+  }
+  
+  /* draw frame */
+  g_draw_frame(dst, window_x + x, window_y + y, window_x + x + w, window_y + y + h, &color->frame);
+  
+  /* adjust position */
+  x += G_MARGIN;
+  y += G_MARGIN;
+  w -= G_MARGIN * 2;
+  h -= G_MARGIN * 2;
+  
+  sheet = g_get_glyph_sheet(dst, color->text.r, color->text.g,
+                            color->text.b, color->text.a);
+  
+  /* draw text loop */
+  dest_x = window_x + x;
+  dest_y = window_y + y;
+  counter = widget->input.first_character;
+  text_length = strlen(widget->input.text);
+  while(counter <= text_length && dest_y < window_y + y + h + G_CHAR_H)
+  {
+    /* write character */
+    if(widget->input.text[counter] != '\0' && dest_y < window_y + y + h)
+    {
+      if(widget->input.flags.hide_text)
+      {
+        g_draw_character(dst, sheet, dest_x, dest_y, widget->input.replace_character,
+                         color->text.r, color->text.g,
+                         color->text.b, color->text.a);
+      }
+      else
+      {
+        g_draw_character(dst, sheet, dest_x, dest_y, widget->input.text[counter],
+                         color->text.r, color->text.g,
+                         color->text.b, color->text.a);
+      }
+    }
+    
+    /* draw cursor */
+    if(widget == active_input_box &&
+       counter == active_input_box->input.cursor_pos)
+    {
+      /* draw cursor in upper right corner */
+      if(dest_y >= window_y + y + G_CHAR_H && dest_x == window_x + x)
+      {
+        vlineRGBA(dst, window_x + x + (active_input_box->input.char_amount_w * G_CHAR_W),
+                  dest_y - 2 - G_CHAR_H, dest_y + 10 - G_CHAR_H,
+                  color->cursor.r, color->cursor.g,
+                  color->cursor.b, color->cursor.a);
+      }
+      else
+      {
+        vlineRGBA(dst, dest_x, dest_y - 2, dest_y + 10,
+                  color->cursor.r, color->cursor.g,
+                  color->cursor.b, color->cursor.a);
+      }
+    }
+    
+    if(dest_x + G_CHAR_W < window_x + x + w)
+    {
+      dest_x += G_CHAR_W;
+    }
+    else
+    {
+      dest_x = window_x + x;
+      dest_y += G_CHAR_H;
+    }
+    
+    counter++;
+  }
+}
+static void g_draw_widget_button(SDL_Surface *dst, const g_widget *widget, const int window_x, const int window_y)
+{
+  const struct g_button_colors *color = widget->button.color ? widget->button.color : &g_get_widget_theme(widget)->button;
+  int x, y, w, h;
+  
+  g_adjust_widget_position_button(widget, &x, &y, &w, &h);
+  
+  /* draw button background; pressed buttons have an inverted gradient */
+  if(widget == clicked_button)
+    g_draw_gradient(dst, window_x + x, window_y + y, w, h, h,
+                    &color->bottom, &color->top);
+  else
+    g_draw_gradient(dst, window_x + x, window_y + y, w, h, h,
+                    &color->top, &color->bottom);
+  
+  /* draw button frame */
+  g_draw_frame(dst, window_x + x - 1, window_y + y - 1, window_x + x + w, window_y + y + h, &color->frame);
+  
+  /* adjust position */
+  x += G_MARGIN;
+  y += G_MARGIN;
+  w -= G_MARGIN * 2;
+  h -= G_MARGIN * 2;
+  
+  /* draw widget text */
+  g_draw_text(dst, widget->button.text, window_x + x, window_y + y, w, h,
+              color->text.r, color->text.g,
+              color->text.b, color->text.a);
+}
+static void g_draw_widget_check_box(SDL_Surface *dst, const g_widget *widget, const int window_x, const int window_y)
+{
+  const struct g_check_box_colors *color = widget->check.color ? widget->check.color : &g_get_widget_theme(widget)->check;
+  int x, y;
+  
+  g_adjust_widget_position_check_box(widget, &x, &y);
+  
+  /* draw background */
+  g_draw_box(dst, window_x + x + 1, window_y + y + 1,
+             window_x + x + G_CHECK_BOX_SIZE - 1, window_y + y + G_CHECK_BOX_SIZE - 1, &color->background);
+  
+  /* draw frame */
+  g_draw_frame(dst, window_x + x, window_y + y,
+          window_x + x + G_CHECK_BOX_SIZE, window_y + y + G_CHECK_BOX_SIZE, &color->frame);
+  
+  /* draw 'X' if check box is enabled */
+  if(widget->check.state)
+  {
+    g_draw_glyph(dst, window_x + x + 5, window_y + y + 5, 'X',
+                 color->mark.r, color->mark.g,
+                 color->mark.b, color->mark.a);
+  }
+}
+static void g_draw_widget_surface(SDL_Surface *dst, const g_widget *widget, const int window_x, const int window_y)
+{
+  SDL_Rect temp_src, temp_dst;
+  int x, y, w, h;
+  
+  g_adjust_widget_position_surface(widget, &x, &y, &w, &h);
+  
+  /* set temp_src x and y */
+  temp_src.x = widget->surface.src_x;
+  temp_src.y = widget->surface.src_y;
+  temp_src.w = w;
+  temp_src.h = h;
+  
+  /* correct temp_dst */
+  temp_dst.x = window_x + x;
+  temp_dst.y = window_y + y;
+  
+  /* blit surface */
+  g_blit_surface(widget->surface.surface, &temp_src, dst, &temp_dst);
+}
+static void g_draw_widget_slider_h(SDL_Surface *dst, const g_widget *widget, const int window_x, const int window_y)
+{
+  const struct g_slider_colors *color = widget->slider.color ? widget->slider.color : &g_get_widget_theme(widget)->slider;
+  int x, y, w;
+  int slider_value;
+  
+  g_adjust_widget_position_slider(widget, &x, &y, &w, NULL);
+  
+  /* draw line; SDL_gfx uses a global buffer for thick lines */
+  g_lock_renderer();
+  thickLineRGBA(dst, window_x + x, window_y + y + G_SLIDER_H/2,
+                window_x + x + w, window_y + y + G_SLIDER_H/2, G_SLIDER_THICKNESS,
+                color->line.r, color->line.g,
+                color->line.b, color->line.a);
+  g_unlock_renderer();
+  
+  if(widget->slider.flags.invert)
+    slider_value = (1 - widget->slider.value/widget->slider.max_value) * (w - G_SLIDER_W);
+  else
+    slider_value = (widget->slider.value/widget->slider.max_value) * (w - G_SLIDER_W);
+  
+  /* draw slider */
+  g_draw_box(dst, window_x + x + slider_value, window_y + y,
+             window_x + x + slider_value + G_SLIDER_W - 1, window_y + y + G_SLIDER_H - 1, &color->slider);
+  
+  /* draw frame */
+  g_draw_frame(dst, window_x + x + slider_value - 1, window_y + y - 1,
+               window_x + x + slider_value + G_SLIDER_W, window_y + y + G_SLIDER_H, &color->frame);
+}
+static void g_draw_widget_slider_v(SDL_Surface *dst, const g_widget *widget, const int window_x, const int window_y)
+{
+  const struct g_slider_colors *color = widget->slider.color ? widget->slider.color : &g_get_widget_theme(widget)->slider;
+  int x, y, h;
+  int slider_value;
+  
+  g_adjust_widget_position_slider(widget, &x, &y, NULL, &h);
+  
+  /* draw line; SDL_gfx uses a global buffer for thick lines */
+  g_lock_renderer();
+  thickLineRGBA(dst, window_x + x + G_SLIDER_H/2, window_y + y,
+                window_x + x + G_SLIDER_H/2, window_y + y + h, G_SLIDER_THICKNESS,
+                color->line.r, color->line.g,
+                color->line.b, color->line.a);
+  g_unlock_renderer();
+  
+  if(widget->slider.flags.invert)
+    slider_value = (widget->slider.value/widget->slider.max_value) * (h - G_SLIDER_W);
+  else
+    slider_value = (1 - widget->slider.value/widget->slider.max_value) * (h - G_SLIDER_W);
+  
+  /* draw slider */
+  g_draw_box(dst, window_x + x, window_y + y + slider_value,
+             window_x + x + G_SLIDER_H - 1, window_y + y + slider_value + G_SLIDER_W - 1, &color->slider);
+  
+  /* draw frame */
+  g_draw_frame(dst, window_x + x - 1, window_y + y + slider_value - 1,
+               window_x + x + G_SLIDER_H, window_y + y + slider_value + G_SLIDER_W, &color->frame);
+}
+static void g_draw_widget_drop_down_list(SDL_Surface *dst, const g_widget *widget, const int window_x, const int window_y)
+{
+  const struct g_drop_down_list_colors *color = widget->drop_down.color ? widget->drop_down.color : &g_get_widget_theme(widget)->drop_down;
+  int x, y, w;
+  
+  g_adjust_widget_position_drop_down_list(widget, &x, &y, &w);
+  
+  /* draw background */
+  g_draw_box(dst, window_x + x, window_y + y, window_x + x + w - 1, window_y + y + G_DROP_DOWN_LIST_SIZE - 1, &color->background);
+  
+  /* draw frame */
+  g_draw_frame(dst, window_x + x - 1, window_y + y - 1, window_x + x + w,
+          window_y + y + G_DROP_DOWN_LIST_SIZE, &color->frame);
+  vlineRGBA(dst, window_x + x + w - G_DROP_DOWN_LIST_SIZE, window_y + y,
+            window_y + y + G_DROP_DOWN_LIST_SIZE - 1,
+            color->frame.r, color->frame.g,
+            color->frame.b, color->frame.a);
+  
+  /* draw arrow pointing down; character number '31' in "SDL_gfxPrimitivesfont.h" */
+  g_draw_glyph(dst, window_x + x + w - G_DROP_DOWN_LIST_SIZE + 7, window_y + y + 8, 31,
+               color->arrow.r, color->arrow.g,
+               color->arrow.b, color->arrow.a);
+  
+  /* draw current item; g_draw_text() stops at the end of the line, because it is only one line high */
+  if(widget->drop_down.current_item >= 0 && widget->drop_down.current_item <= widget->drop_down.max_item)
+  {
+    /* adjust position */
+    x += G_MARGIN;
+    y += G_MARGIN;
+    w -= G_MARGIN * 2 + G_DROP_DOWN_LIST_SIZE;
+    
+    g_draw_text(dst, widget->drop_down.text + widget->drop_down.items[widget->drop_down.current_item].offset,
+                window_x + x, window_y + y, w, G_CHAR_H,
+                color->text.r, color->text.g,
+                color->text.b, color->text.a);
+  }
+}
+
+static void g_draw_widget(SDL_Surface *dst, const g_widget *widget, const int window_x, const int window_y)
+{
+  /* return if widget is outside the window */
+  if((widget->x > widget->window->w - widget->window->margin) ||
+    (widget->y > widget->window->h - widget->window->margin))
+    return;
+  
+  widget_classes[widget->type].draw(dst, widget, window_x, window_y);
+}
+
+static void g_draw_active_drop_down_list(SDL_Surface *dst)
+{
+  const struct g_widget_drop_down_list *list = &active_drop_down_list->drop_down;
+  const struct g_drop_down_list_colors *color = list->color ? list->color : &g_get_widget_theme(active_drop_down_list)->drop_down;
+  SDL_Rect clip_rect;
+  int x, y, w, h;
+  int temp_x, temp_y;
+  int item, last_item;
+  
+  g_adjust_widget_position_drop_down_list_size(active_drop_down_list, &x, &y, &w, &h);
+  
+  /* draw background */
+  g_draw_box(dst, x, y, x + w - 1, y + h, &color->background_list);
+  
+  /* draw frame */
+  g_draw_frame(dst, x - 1, y, x + w, y + h + 1, &color->frame);
+  
+  /* highlight current item */
+  SDL_GetMouseState(&temp_x, &temp_y);
+  if(temp_x > x && temp_x < x + w && temp_y > y && temp_y < y + h)
+  {
+    g_draw_box(dst, x, y + ((temp_y - y)/G_CHAR_H) * G_CHAR_H + 1,
+               x + w - 1, y + ((temp_y - y)/G_CHAR_H) * G_CHAR_H + G_CHAR_H, &color->highlight);
+  }
+  
+  /* adjust position */
+  x += G_MARGIN;
+  y += G_MARGIN/2;
+  w -= G_MARGIN;
+  h += G_MARGIN/2;
+  
+  /* draw only the items inside the clip rect */
+  SDL_GetClipRect(dst, &clip_rect);
+  
+  item = (clip_rect.y - y)/G_CHAR_H;
+  if(item < 0)
+    item = 0;
+  
+  last_item = (clip_rect.y + clip_rect.h - y)/G_CHAR_H;
+  if(last_item > list->max_item)
+    last_item = list->max_item;
+  
+  for(; item <= last_item; item++)
+  {
+    g_draw_text(dst, list->text + list->items[item].offset, x, y + item * G_CHAR_H, w, G_CHAR_H,
+                color->text.r, color->text.g, color->text.b, color->text.a);
+  }
+}
+
+/* window draw functions */
+/* draws the window with its body at window_x/window_y on dst */
+static void g_render_window(SDL_Surface *dst, const g_window *window, const int window_x, const int window_y)
+{
+  const struct g_window_colors *color = g_get_window_colors(window);
+  g_widget *widget = NULL;
+  const struct g_widget_rect *area;
+  char temp_string[G_TEXT_LENGTH] = {0};
+  SDL_Rect clip_rect, body;
+  
+  int counter;
+  int x, y, w, h;
+  
+  /* draw title bar start */
+  if(window->flags.title_bar)
+  {
+    /* draw tile bar background */
+    if(window->flags.close_button)
+      g_draw_gradient(dst, window_x, window_y - G_WINDOW_TITLE_BAR_HEIGHT, window->w - G_WINDOW_CLOSE_BUTTON_WIDTH,
+                      G_WINDOW_TITLE_BAR_HEIGHT, G_WINDOW_TITLE_BAR_HEIGHT - 1,
+                      &color->title_bar_top, &color->title_bar_bottom);
+    else
+      g_draw_gradient(dst, window_x, window_y - G_WINDOW_TITLE_BAR_HEIGHT, window->w,
+                      G_WINDOW_TITLE_BAR_HEIGHT, G_WINDOW_TITLE_BAR_HEIGHT - 1,
+                      &color->title_bar_top, &color->title_bar_bottom);
+    
+    /* draw frame */
+    hlineRGBA(dst, window_x - 1, window_x + window->w, window_y - G_WINDOW_TITLE_BAR_HEIGHT - 1,
+              color->frame.r, color->frame.g, color->frame.b, color->frame.a);
+    vlineRGBA(dst, window_x - 1, window_y - 2, window_y - G_WINDOW_TITLE_BAR_HEIGHT,
+              color->frame.r, color->frame.g, color->frame.b, color->frame.a);
+    vlineRGBA(dst, window_x + window->w, window_y - G_WINDOW_TITLE_BAR_HEIGHT, window_y - 2,
+              color->frame.r, color->frame.g, color->frame.b, color->frame.a);
+    
+    /* draw close button */
+    if(window->flags.close_button)
+    {
+      /* draw close button background */
+      g_draw_gradient(dst, window_x + window->w - G_WINDOW_CLOSE_BUTTON_WIDTH + 1, window_y - G_WINDOW_TITLE_BAR_HEIGHT,
+                      G_WINDOW_CLOSE_BUTTON_WIDTH - 1, G_WINDOW_TITLE_BAR_HEIGHT, G_WINDOW_TITLE_BAR_HEIGHT - 1,
+                      &color->close_button_top, &color->close_button_bottom);
+      
+      /* draw frame */
+      vlineRGBA(dst, window_x + window->w - G_WINDOW_CLOSE_BUTTON_WIDTH, window_y - G_WINDOW_TITLE_BAR_HEIGHT,
+                window_y - 2, color->frame.r, color->frame.g,
+                color->frame.b, color->frame.a);
+      
+      /* write close button character */
+      g_draw_glyph(dst, window_x + window->w - G_WINDOW_CLOSE_BUTTON_WIDTH + G_MARGIN,
+                   window_y - G_WINDOW_TITLE_BAR_HEIGHT + G_MARGIN, window->close_button_character,
+                   color->close_button_text.r, color->close_button_text.g,
+                   color->close_button_text.b, color->close_button_text.a);
+      
+      /* calculate how much characters fit in title bar */
+      counter = (window->w - G_WINDOW_CLOSE_BUTTON_WIDTH - 2 * G_MARGIN)/G_CHAR_W;
+    }
+    else
+      counter = (window->w - 2 * G_MARGIN)/G_CHAR_W;
+    
+    /* text should fit in title bar */
+    if(strlen(window->title) > counter)
+    {
+      /* shorten text */
+      strncpy(temp_string, window->title, counter);
+      temp_string[counter - 3] = '.';
+      temp_string[counter - 2] = '.';
+      temp_string[counter - 1] = '.';
+      temp_string[counter] = '\0';
+    }
+    else
+      strcpy(temp_string, window->title);
+    
+    /* write text in center of title bar */
+    if(window->flags.close_button)
+    {
+      g_draw_string(dst, window_x + (window->w - G_WINDOW_CLOSE_BUTTON_WIDTH)/2 - (strlen(temp_string) * G_CHAR_W)/2,
+                    window_y - G_WINDOW_TITLE_BAR_HEIGHT + G_MARGIN, temp_string,
+                    color->title_text.r, color->title_text.g,
+                    color->title_text.b, color->title_text.a);
+    }
+    else
+    {
+      g_draw_string(dst, window_x + window->w/2 - (strlen(temp_string) * G_CHAR_W)/2,
+                    window_y - G_WINDOW_TITLE_BAR_HEIGHT + G_MARGIN, temp_string,
+                    color->title_text.r, color->title_text.g,
+                    color->title_text.b, color->title_text.a);
+    }
+  }
+  /* draw title bar end */
+  
+  /* draw window body with frame */
+  g_draw_box(dst, window_x, window_y, window_x + window->w - 1, window_y + window->h - 1, &color->background);
+  g_draw_frame(dst, window_x - 1, window_y - 1, window_x + window->w, window_y + window->h, &color->frame);
+  
+  /* draw all widgets inside the current clip rect, without drawing over the window frame */
+  SDL_GetClipRect(dst, &clip_rect);
+  body.x = window_x;
+  body.y = window_y;
+  body.w = window->w;
+  body.h = window->h;
+  
+  if(g_intersect_rect(&clip_rect, &body, &body))
+  {
+    SDL_SetClipRect(dst, &body);
+    
+    if(g_hit_grid_is_current(window))
+    {
+      /* cull the widgets using the packed areas */
+      for(counter = 0; counter < window->hit_grid.widget_amount; counter++)
+      {
+        area = &window->hit_grid.areas[counter];
+        if(g_rect_intersects(&body, window_x + area->x, window_y + area->y, area->w, area->h))
+          g_draw_widget(dst, window->hit_grid.widgets[counter], window_x, window_y);
+      }
+    }
+    else
+    {
+      for(widget = window->first_widget; widget; widget = widget->next)
+      {
+        g_get_widget_area(widget, &x, &y, &w, &h);
+        if(g_rect_intersects(&body, window_x + x, window_y + y, w, h))
+          g_draw_widget(dst, widget, window_x, window_y);
+      }
+    }
+    
+    SDL_SetClipRect(dst, &clip_rect);
+  }
+  
+  /* draw resziable mark */
+  if(window->flags.resizable)
+  {
+    pixelRGBA(dst, window_x + window->w - 2, window_y + window->h - 2, color->resize_mark.r, color->resize_mark.g, color->resize_mark.b, color->resize_mark.a);
+    pixelRGBA(dst, window_x + window->w - 4, window_y + window->h - 4, color->resize_mark.r, color->resize_mark.g, color->resize_mark.b, color->resize_mark.a);
+    
+    pixelRGBA(dst, window_x + window->w - 4, window_y + window->h - 2, color->resize_mark.r, color->resize_mark.g, color->resize_mark.b, color->resize_mark.a);
+    pixelRGBA(dst, window_x + window->w - 6, window_y + window->h - 2, color->resize_mark.r, color->resize_mark.g, color->resize_mark.b, color->resize_mark.a);
+    pixelRGBA(dst, window_x + window->w - 6, window_y + window->h - 4, color->resize_mark.r, color->resize_mark.g, color->resize_mark.b, color->resize_mark.a);
+    pixelRGBA(dst, window_x + window->w - 8, window_y + window->h - 2, color->resize_mark.r, color->resize_mark.g, color->resize_mark.b, color->resize_mark.a);
+    
+    pixelRGBA(dst, window_x + window->w - 2, window_y + window->h - 4, color->resize_mark.r, color->resize_mark.g, color->resize_mark.b, color->resize_mark.a);
+    pixelRGBA(dst, window_x + window->w - 2, window_y + window->h - 6, color->resize_mark.r, color->resize_mark.g, color->resize_mark.b, color->resize_mark.a);
+    pixelRGBA(dst, window_x + window->w - 4, window_y + window->h - 6, color->resize_mark.r, color->resize_mark.g, color->resize_mark.b, color->resize_mark.a);
+    pixelRGBA(dst, window_x + window->w - 2, window_y + window->h - 8, color->resize_mark.r, color->resize_mark.g, color->resize_mark.b, color->resize_mark.a);
+  }
+}
+static int g_window_is_opaque(const g_window *window)
+{
+  const struct g_window_colors *color = g_get_window_colors(window);
+  
+  /* the frame, body and title bar of a window cover its whole area */
+  if(color->frame.a != 255 || color->background.a != 255)
+    return 0;
+  
+  if(window->flags.title_bar &&
+     (color->title_bar_top.a != 255 || color->title_bar_bottom.a != 255))
+    return 0;
+  
+  if(window->flags.title_bar && window->flags.close_button &&
+     (color->close_button_top.a != 255 || color->close_button_bottom.a != 255))
+    return 0;
+  
+  return 1;
+}
+static void g_free_window_cache(g_window *window)
+{
+  if(window->cache)
+  {
+    SDL_FreeSurface(window->cache);
+    window->cache = NULL;
+  }
+}
+/* updates the cache of the window; returns 0 if the window must be drawn without cache */
+static int g_prepare_window_cache(SDL_Surface *dst, g_window *window)
+{
+  int x, y, w, h;
+  
+  /* translucent windows depend on the pixels below them, so they cant be cached */
+  if(!window->flags.cached || !g_window_is_opaque(window) || dst->format->BitsPerPixel < 16)
+  {
+    if(!render_active)
+      g_free_window_cache(window);
+    
+    return 0;
+  }
+  
+  g_get_window_area(window, &x, &y, &w, &h);
+  
+  /* caches are updated before parallel rendering starts */
+  if(render_active)
+    return window->cache && window->cache_valid &&
+           window->cache->w == w && window->cache->h == h &&
+           g_same_format(window->cache->format, dst->format);
+  
+  /* recreate cache if window size or destination format has changed */
+  if(window->cache &&
+     (window->cache->w != w || window->cache->h != h ||
+      !g_same_format(window->cache->format, dst->format)))
+    g_free_window_cache(window);
+  
+  if(!window->cache)
+  {
+    window->cache = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, dst->format->BitsPerPixel,
+                                         dst->format->Rmask, dst->format->Gmask,
+                                         dst->format->Bmask, 0);
+    
+    /* draw window directly, if there is not enough memory */
+    if(!window->cache)
+      return 0;
+    
+    window->cache_valid = 0;
+  }
+  
+  /* redraw window into its cache */
+  if(!window->cache_valid)
+  {
+    g_render_window(window->cache, window, window->x - x, window->y - y);
+    window->cache_valid = 1;
+  }
+  
+  return 1;
+}
+static void g_draw_window(SDL_Surface *dst, g_window *window)
+{
+  SDL_Rect temp_dst;
+  int x, y, w, h;
+  
+  /* return if window is not visible */
+  if(!window->flags.visible)
+    return;
+  
+  /* the widget areas are updated before parallel rendering starts */
+  if(!render_active)
+    g_update_hit_grid(window);
+  
+  if(!g_prepare_window_cache(dst, window))
+  {
+    g_render_window(dst, window, window->x, window->y);
+    return;
+  }
+  
+  g_get_window_area(window, &x, &y, &w, &h);
+  
+  temp_dst.x = x;
+  temp_dst.y = y;
+  g_blit_surface(window->cache, NULL, dst, &temp_dst);
+}
+/* stores the part of 'window' inside 'clip', which is not hidden by opaque windows above it, in 'exposed';
+   returns 0 if the window is completely hidden */
+static int g_get_exposed_area(const g_window *window, const SDL_Rect *clip, SDL_Rect *exposed)
+{
+  g_window *above = NULL;
+  int x1, y1, x2, y2;
+  int x, y, w, h;
+  
+  /* start with the part of the window inside the clip rect */
+  g_get_window_area(window, &x, &y, &w, &h);
+  x1 = (x > clip->x) ? x : clip->x;
+  y1 = (y > clip->y) ? y : clip->y;
+  x2 = (x + w < clip->x + clip->w) ? x + w : clip->x + clip->w;
+  y2 = (y + h < clip->y + clip->h) ? y + h : clip->y + clip->h;
+  
+  /* cut off everything, which is covered by an opaque window */
+  for(above = window->next; above && x1 < x2 && y1 < y2; above = above->next)
+  {
+    if(!above->flags.visible || !g_window_is_opaque(above))
+      continue;
+    
+    g_get_window_area(above, &x, &y, &w, &h);
+    
+    /* only strips over a whole side can be cut off, because the result must stay a rectangle */
+    if(x <= x1 && x + w >= x2)
+    {
+      if(y <= y1 && y + h > y1)
+        y1 = y + h;
+      else if(y < y2 && y + h >= y2)
+        y2 = y;
+    }
+    else if(y <= y1 && y + h >= y2)
+    {
+      if(x <= x1 && x + w > x1)
+        x1 = x + w;
+      else if(x < x2 && x + w >= x2)
+        x2 = x;
+    }
+  }
+  
+  if(x1 >= x2 || y1 >= y2)
+    return 0;
+  
+  exposed->x = x1;
+  exposed->y = y1;
+  exposed->w = x2 - x1;
+  exposed->h = y2 - y1;
+  
+  return 1;
+}
+/* draws only the visible part of a window; 'clip' must be the current clip rect of dst */
+static void g_draw_window_exposed(SDL_Surface *dst, g_window *window, const SDL_Rect *clip)
+{
+  SDL_Rect exposed;
+  
+  if(!window->flags.visible || !g_get_exposed_area(window, clip, &exposed))
+    return;
+  
+  SDL_SetClipRect(dst, &exposed);
+  g_draw_window(dst, window);
+  SDL_SetClipRect(dst, clip);
+}
+/* draws all windows and the active drop down list inside 'rect' */
+static void g_draw_region(SDL_Surface *dst, const SDL_Rect *rect)
+{
+  g_window *window = NULL;
+  int x, y, w, h;
+  
+  SDL_SetClipRect(dst, rect);
+  
+  for(window = first_window; window; window = window->next)
+    g_draw_window_exposed(dst, window, rect);
+  
+  if(active_drop_down_list)
+  {
+    g_adjust_widget_position_drop_down_list_size(active_drop_down_list, &x, &y, &w, &h);
+    if(g_rect_intersects(rect, x - 1, y, w + 2, h + 2))
+      g_draw_active_drop_down_list(dst);
+  }
+}
+/* splits the area covered by 'rects' into tiles, which dont overlap; returns 0 on failure */
+static int g_build_tiles(const SDL_Rect *rects, const int amount)
+{
+  SDL_Rect *temp_tiles;
+  int x1, y1, x2, y2;
+  int tile_x1, tile_y1, tile_x2, tile_y2;
+  int cell_x, cell_y;
+  int counter, needed;
+  
+  render_tile_amount = 0;
+  
+  if(amount <= 0)
+    return 1;
+  
+  /* calculate bounding box */
+  x1 = rects[0].x;
+  y1 = rects[0].y;
+  x2 = rects[0].x + rects[0].w;
+  y2 = rects[0].y + rects[0].h;
+  for(counter = 1; counter < amount; counter++)
+  {
+    x1 = (rects[counter].x < x1) ? rects[counter].x : x1;
+    y1 = (rects[counter].y < y1) ? rects[counter].y : y1;
+    x2 = (rects[counter].x + rects[counter].w > x2) ? rects[counter].x + rects[counter].w : x2;
+    y2 = (rects[counter].y + rects[counter].h > y2) ? rects[counter].y + rects[counter].h : y2;
+  }
+  
+  /* align to the tile grid */
+  x1 -= x1 % G_RENDER_TILE_SIZE;
+  y1 -= y1 % G_RENDER_TILE_SIZE;
+  
+  needed = ((x2 - x1 + G_RENDER_TILE_SIZE - 1)/G_RENDER_TILE_SIZE) * ((y2 - y1 + G_RENDER_TILE_SIZE - 1)/G_RENDER_TILE_SIZE);
+  if(needed > render_tile_capacity)
+  {
+    temp_tiles = realloc(render_tiles, needed * sizeof(SDL_Rect));
+    if(!temp_tiles)
+      return 0;
+    
+    render_tiles = temp_tiles;
+    render_tile_capacity = needed;
+  }
+  
+  /* each tile covers the parts of all rects inside one grid cell */
+  for(cell_y = y1; cell_y < y2; cell_y += G_RENDER_TILE_SIZE)
+  {
+    for(cell_x = x1; cell_x < x2; cell_x += G_RENDER_TILE_SIZE)
+    {
+      tile_x1 = cell_x + G_RENDER_TILE_SIZE;
+      tile_y1 = cell_y + G_RENDER_TILE_SIZE;
+      tile_x2 = cell_x;
+      tile_y2 = cell_y;
+      
+      for(counter = 0; counter < amount; counter++)
+      {
+        if(!g_rect_intersects(&rects[counter], cell_x, cell_y, G_RENDER_TILE_SIZE, G_RENDER_TILE_SIZE))
+          continue;
+        
+        tile_x1 = (rects[counter].x < tile_x1) ? rects[counter].x : tile_x1;
+        tile_y1 = (rects[counter].y < tile_y1) ? rects[counter].y : tile_y1;
+        tile_x2 = (rects[counter].x + rects[counter].w > tile_x2) ? rects[counter].x + rects[counter].w : tile_x2;
+        tile_y2 = (rects[counter].y + rects[counter].h > tile_y2) ? rects[counter].y + rects[counter].h : tile_y2;
+      }
+      
+      /* cut off everything outside of the cell */
+      tile_x1 = (tile_x1 > cell_x) ? tile_x1 : cell_x;
+      tile_y1 = (tile_y1 > cell_y) ? tile_y1 : cell_y;
+      tile_x2 = (tile_x2 < cell_x + G_RENDER_TILE_SIZE) ? tile_x2 : cell_x + G_RENDER_TILE_SIZE;
+      tile_y2 = (tile_y2 < cell_y + G_RENDER_TILE_SIZE) ? tile_y2 : cell_y + G_RENDER_TILE_SIZE;
+      
+      if(tile_x1 < tile_x2 && tile_y1 < tile_y2)
+      {
+        render_tiles[render_tile_amount].x = tile_x1;
+        render_tiles[render_tile_amount].y = tile_y1;
+        render_tiles[render_tile_amount].w = tile_x2 - tile_x1;
+        render_tiles[render_tile_amount].h = tile_y2 - tile_y1;
+        render_tile_amount++;
+      }
+    }
+  }
+  
+  return 1;
+}
+/* draws tiles until all tiles are taken */
+static void g_render_tiles(SDL_Surface *target)
+{
+  int tile;
+  
+  while(1)
+  {
+    SDL_mutexP(render_lock);
+    tile = render_next_tile++;
+    SDL_mutexV(render_lock);
+    
+    if(tile >= render_tile_amount)
+      return;
+    
+    g_draw_region(target, &render_tiles[tile]);
+  }
+}
+static int g_render_thread(void *data)
+{
+  SDL_Surface **target = data;
+  
+  while(1)
+  {
+    SDL_SemWait(render_start);
+    
+    if(render_quit)
+      return 0;
+    
+    g_render_tiles(*target);
+    SDL_SemPost(render_done);
+  }
+}
+/* returns a surface sharing the pixels of 'dst', or NULL on failure */
+static SDL_Surface *g_update_render_target(SDL_Surface *target, SDL_Surface *dst)
+{
+  if(target &&
+     (target->w != dst->w || target->h != dst->h || target->pitch != dst->pitch ||
+      !g_same_format(target->format, dst->format) || target->format->Amask != dst->format->Amask))
+  {
+    SDL_FreeSurface(target);
+    target = NULL;
+  }
+  
+  if(!target)
+    return SDL_CreateRGBSurfaceFrom(dst->pixels, dst->w, dst->h, dst->format->BitsPerPixel, dst->pitch,
+                                    dst->format->Rmask, dst->format->Gmask,
+                                    dst->format->Bmask, dst->format->Amask);
+  
+  target->pixels = dst->pixels;
+  return target;
+}
+/* draws 'rects' with all render threads; returns 0 if parallel rendering is not possible */
+static int g_draw_regions_parallel(SDL_Surface *dst, const SDL_Rect *rects, const int amount, const int background)
+{
+  g_window *window = NULL;
+  g_widget *widget = NULL;
+  SDL_Rect clip_rect, exposed;
+  int counter;
+  int x, y, w, h;
+  
+  if(render_thread_amount == 0 || dst->format->BitsPerPixel < 16 || !g_build_tiles(rects, amount))
+    return 0;
+  
+  SDL_GetClipRect(dst, &clip_rect);
+  
+  /* the background function and the window caches are handled before the threads start */
+  if(background && background_function)
+  {
+    for(counter = 0; counter < render_tile_amount; counter++)
+    {
+      SDL_SetClipRect(dst, &render_tiles[counter]);
+      background_function(dst, &render_tiles[counter], background_data);
+    }
+    
+    SDL_SetClipRect(dst, &clip_rect);
+  }
+  
+  for(window = first_window; window; window = window->next)
+  {
+    if(!window->flags.visible || !g_get_exposed_area(window, &clip_rect, &exposed))
+      continue;
+    
+    /* widget areas get cached here, so the threads only read them */
+    if(!g_update_hit_grid(window))
+      for(widget = window->first_widget; widget; widget = widget->next)
+        g_get_widget_area(widget, &x, &y, &w, &h);
+    
+    g_prepare_window_cache(dst, window);
+  }
+  
+  if(active_drop_down_list)
+    g_adjust_widget_position_drop_down_list_size(active_drop_down_list, &x, &y, &w, &h);
+  
+  if(SDL_MUSTLOCK(dst) && SDL_LockSurface(dst) < 0)
+    return 0;
+  
+  /* each thread draws into its own surface, which shares the pixels of dst */
+  for(counter = 0; counter <= render_thread_amount; counter++)
+  {
+    render_targets[counter] = g_update_render_target(render_targets[counter], dst);
+    if(!render_targets[counter])
+      break;
+  }
+  render_blit_target = g_update_render_target(render_blit_target, dst);
+  
+  if(counter <= render_thread_amount || !render_blit_target)
+  {
+    if(SDL_MUSTLOCK(dst))
+      SDL_UnlockSurface(dst);
+    
+    return 0;
+  }
+  
+  glyph_frame_uses = glyph_sheet_uses;
+  gradient_frame_uses = gradient_strip_uses;
+  g_set_mapped_format(dst->format);
+  render_next_tile = 0;
+  render_active = 1;
+  
+  for(counter = 0; counter < render_thread_amount; counter++)
+    SDL_SemPost(render_start);
+  
+  g_render_tiles(render_targets[0]);
+  
+  for(counter = 0; counter < render_thread_amount; counter++)
+    SDL_SemWait(render_done);
+  
+  render_active = 0;
+  
+  if(SDL_MUSTLOCK(dst))
+    SDL_UnlockSurface(dst);
+  
+  return 1;
+}
+/* draws 'rects' and calls the background function for them, if 'background' is not 0 */
+static void g_draw_regions(SDL_Surface *dst, const SDL_Rect *rects, const int amount, const int background)
+{
+  int counter;
+  
+  if(g_draw_regions_parallel(dst, rects, amount, background))
+    return;
+  
+  for(counter = 0; counter < amount; counter++)
+  {
+    SDL_SetClipRect(dst, &rects[counter]);
+    
+    if(background && background_function)
+      background_function(dst, &rects[counter], background_data);
+    
+    g_draw_region(dst, &rects[counter]);
+  }
+}
+static void g_stop_render_threads(void)
+{
+  int counter;
+  
+  if(render_thread_amount > 0)
+  {
+    render_quit = 1;
+    
+    for(counter = 0; counter < render_thread_amount; counter++)
+      SDL_SemPost(render_start);
+    
+    for(counter = 0; counter < render_thread_amount; counter++)
+      SDL_WaitThread(render_threads[counter], NULL);
+    
+    render_quit = 0;
+    render_thread_amount = 0;
+  }
+  
+  for(counter = 0; counter < G_MAX_RENDER_THREADS; counter++)
+  {
+    if(render_targets[counter])
+    {
+      SDL_FreeSurface(render_targets[counter]);
+      render_targets[counter] = NULL;
+    }
+  }
+  
+  if(render_blit_target)
+  {
+    SDL_FreeSurface(render_blit_target);
+    render_blit_target = NULL;
+  }
+  
+  if(render_start)
+  {
+    SDL_DestroySemaphore(render_start);
+    render_start = NULL;
+  }
+  if(render_done)
+  {
+    SDL_DestroySemaphore(render_done);
+    render_done = NULL;
+  }
+  if(render_lock)
+  {
+    SDL_DestroyMutex(render_lock);
+    render_lock = NULL;
+  }
+  
+  free(render_tiles);
+  render_tiles = NULL;
+  render_tile_amount = 0;
+  render_tile_capacity = 0;
+}
+/* widget event handlers */
+/* they are called for mouse events inside the hit area; event->x/y is the mouse position inside it */
+/* makes room for 'length' characters and the terminating '\0' in the text of an input box */
+static int g_grow_input_box_text(g_widget *widget, const int length)
 {
-  g_window *window = widget->window;
-  int x, y, w, h;
+  char *text;
+  int size = widget->input.text_size;
   
-  g_adjust_widget_position(widget, &x, &y, &w, &h);
+  if(length < size)
+    return 1;
   
-  /* draw widget text */
-  g_draw_text(dst, widget->text.text, window->x + x, window->y + y, w, h,
-              widget->text.color.text.r, widget->text.color.text.g,
-              widget->text.color.text.b, widget->text.color.text.a);
+  while(size <= length)
+    size *= 2;
+  
+  text = realloc(widget->input.text, size);
+  if(!text)
+    return 0;
+  
+  widget->input.text = text;
+  widget->input.text_size = size;
+  
+  return 1;
 }
-static void g_draw_widget_input_box(SDL_Surface *dst, const g_widget *widget)
+static void g_handle_widget_event_input_box(g_widget *widget, const g_event *event, const int w, const int h)
 {
-  g_window *window = widget->window;
-  int x, y, w, h;
-  int dest_x, dest_y;
-  int counter;
-  int text_length;
+  (void)w;
   
-  g_adjust_widget_position(widget, &x, &y, &w, &h);
+  if(event->type != G_CLICK_LEFT)
+    return;
   
-  /* draw background */
-  if(widget == active_input_box)
-  {
-    boxRGBA(dst, window->x + x + 1, window->y + y + 1,
-            window->x + x + w - 1, window->y + y + h - 1,
-            widget->input.color.background_active.r, widget->input.color.background_active.g,
-            widget->input.color.background_active.b, widget->input.color.background_active.a);
-  }
-  else
-  {
-    boxRGBA(dst, window->x + x + 1, window->y + y + 1,
-            window->x + x + w - 1, window->y + y + h - 1,
-            widget->input.color.background.r, widget->input.color.background.g,
-            widget->input.color.background.b, widget->input.color.background.a);
-  }
+  g_enter_input_box(widget);
   
-  /* draw frame */
-  rectangleRGBA(dst, window->x + x, window->y + y, window->x + x + w, window->y + y + h,
-                widget->input.color.frame.r, widget->input.color.frame.g,
-                widget->input.color.frame.b, widget->input.color.frame.a);
+  /* set horizontal cursor position */
+  active_input_box->input.cursor_pos = event->x/G_CHAR_W;
   
-  /* adjust position */
-  x += G_MARGIN;
-  y += G_MARGIN;
-  w -= G_MARGIN * 2;
-  h -= G_MARGIN * 2;
+  if(active_input_box->input.cursor_pos > active_input_box->input.char_amount_w)
+    active_input_box->input.cursor_pos = active_input_box->input.char_amount_w;
   
-  /* draw text loop */
-  dest_x = window->x + x;
-  dest_y = window->y + y;
-  counter = widget->input.first_character;
-  text_length = strlen(widget->input.text);
-  while(counter <= text_length && dest_y < window->y + y + h + G_CHAR_H)
+  /* if input box has more then 1 lines */
+  if(h > G_INPUT_BOX_H)
   {
-    /* write character */
-    if(widget->input.text[counter] != '\0' && dest_y < window->y + y + h)
-    {
-      if(widget->input.flags.hide_text)
-      {
-        characterRGBA(dst, dest_x, dest_y, widget->input.replace_character,
-                      widget->input.color.text.r, widget->input.color.text.g,
-                      widget->input.color.text.b, widget->input.color.text.a);
-      }
-      else
-      {
-        characterRGBA(dst, dest_x, dest_y, widget->input.text[counter],
-                      widget->input.color.text.r, widget->input.color.text.g,
-                      widget->input.color.text.b, widget->input.color.text.a);
-      }
-    }
-    
-    /* draw cursor */
-    if(widget == active_input_box &&
-       counter == active_input_box->input.cursor_pos)
-    {
-      /* draw cursor in upper right corner */
-      if(dest_y >= window->y + y + G_CHAR_H && dest_x == window->x + x)
-      {
-        vlineRGBA(dst, window->x + x + (active_input_box->input.char_amount_w * G_CHAR_W),
-                  dest_y - 2 - G_CHAR_H, dest_y + 10 - G_CHAR_H,
-                  widget->input.color.cursor.r, widget->input.color.cursor.g,
-                  widget->input.color.cursor.b, widget->input.color.cursor.a);
-      }
-      else
-      {
-        vlineRGBA(dst, dest_x, dest_y - 2, dest_y + 10,
-                  widget->input.color.cursor.r, widget->input.color.cursor.g,
-                  widget->input.color.cursor.b, widget->input.color.cursor.a);
-      }
-    }
+    active_input_box->input.cursor_pos += (event->y - G_CHAR_H)/G_CHAR_H * active_input_box->input.char_amount_w;
     
-    if(dest_x + G_CHAR_W < window->x + x + w)
-    {
-      dest_x += G_CHAR_W;
-    }
-    else
-    {
-      dest_x = window->x + x;
-      dest_y += G_CHAR_H;
-    }
+    if(event->y > G_MARGIN + G_CHAR_H && event->x < G_MARGIN)
+      active_input_box->input.cursor_pos++;
     
-    counter++;
+    if(active_input_box->input.cursor_pos > active_input_box->input.char_amount)
+      active_input_box->input.cursor_pos -= active_input_box->input.char_amount_w;
   }
+  
+  active_input_box->input.cursor_pos += widget->input.first_character;
+  if(active_input_box->input.cursor_pos > strlen(widget->input.text))
+    active_input_box->input.cursor_pos = strlen(widget->input.text);
 }
-static void g_draw_widget_button(SDL_Surface *dst, const g_widget *widget)
+static void g_handle_widget_event_button(g_widget *widget, const g_event *event, const int w, const int h)
 {
-  g_window *window = widget->window;
-  int x, y, w, h;
-  
-  int counter;
-  float r, g, b, a;
-  float r_step, g_step, b_step, a_step;
-  
-  g_adjust_widget_position_button(widget, &x, &y, &w, &h);
+  (void)w;
+  (void)h;
   
-  /* reset colors and calculate color steps */
-  if(widget == clicked_button)
+  if(event->type == G_CLICK_LEFT)
   {
-    r = widget->button.color.bottom.r;
-    g = widget->button.color.bottom.g;
-    b = widget->button.color.bottom.b;
-    a = widget->button.color.bottom.a;
-    
-    r_step = ((float)widget->button.color.bottom.r - (float)widget->button.color.top.r)/(float)h;
-    g_step = ((float)widget->button.color.bottom.g - (float)widget->button.color.top.g)/(float)h;
-    b_step = ((float)widget->button.color.bottom.b - (float)widget->button.color.top.b)/(float)h;
-    a_step = ((float)widget->button.color.bottom.a - (float)widget->button.color.top.a)/(float)h;
+    clicked_button = widget;
+    g_damage_widget(widget);
   }
-  else
+}
+static void g_handle_widget_event_check_box(g_widget *widget, const g_event *event, const int w, const int h)
+{
+  (void)w;
+  (void)h;
+  
+  if(event->type == G_CLICK_LEFT)
   {
-    r = widget->button.color.top.r;
-    g = widget->button.color.top.g;
-    b = widget->button.color.top.b;
-    a = widget->button.color.top.a;
+    if(widget->check.state)
+      widget->check.state = 0;
+    else
+      widget->check.state = 1;
+    
+    changed_widget = widget;
     
-    r_step = ((float)widget->button.color.top.r - (float)widget->button.color.bottom.r)/(float)h;
-    g_step = ((float)widget->button.color.top.g - (float)widget->button.color.bottom.g)/(float)h;
-    b_step = ((float)widget->button.color.top.b - (float)widget->button.color.bottom.b)/(float)h;
-    a_step = ((float)widget->button.color.top.a - (float)widget->button.color.bottom.a)/(float)h;
+    g_damage_widget(widget);
   }
+}
+/* moves the slider by one mouse wheel step */
+static void g_scroll_slider(g_widget *widget, const g_event_type direction)
+{
+  if((direction == G_WHEEL_UP) != (widget->slider.flags.invert != 0))
+    widget->slider.value += widget->slider.max_value * G_SLIDER_MOUSEWHEEL_STEP;
+  else
+    widget->slider.value -= widget->slider.max_value * G_SLIDER_MOUSEWHEEL_STEP;
+  
+  if(widget->slider.value < 0)
+    widget->slider.value = 0;
+  else if(widget->slider.value > widget->slider.max_value)
+    widget->slider.value = widget->slider.max_value;
+}
+static void g_handle_widget_event_slider_h(g_widget *widget, const g_event *event, const int w, const int h)
+{
+  double old_value = widget->slider.value;
+  
+  (void)h;
+  
+  if(event->type == G_MOUSE_MOTION)
+    return;
   
-  /* draw button background */
-  for(counter = window->y + y; counter < window->y + y + h; counter++)
+  if(event->type == G_CLICK_LEFT)
   {
-    hlineRGBA(dst, window->x + x, window->x + x + w - 1, counter, r, g, b, a);
+    if(widget->slider.flags.invert)
+      widget->slider.value = widget->slider.max_value * ((float)(w - event->x)/(float)w);
+    else
+      widget->slider.value = widget->slider.max_value * ((float)event->x/(float)w);
     
-    r -= r_step;
-    g -= g_step;
-    b -= b_step;
-    a -= a_step;
+    clicked_slider = widget;
   }
+  else if(widget->slider.flags.mouse_wheel && (event->type == G_WHEEL_UP || event->type == G_WHEEL_DOWN))
+    g_scroll_slider(widget, event->type);
   
-  /* draw button frame */
-  rectangleRGBA(dst, window->x + x - 1, window->y + y - 1, window->x + x + w, window->y + y + h,
-                widget->button.color.frame.r, widget->button.color.frame.g,
-                widget->button.color.frame.b, widget->button.color.frame.a);
-  
-  /* adjust position */
-  x += G_MARGIN;
-  y += G_MARGIN;
-  w -= G_MARGIN * 2;
-  h -= G_MARGIN * 2;
+  if(widget->slider.value != old_value)
+    changed_widget = widget;
   
-  /* draw widget text */
-  g_draw_text(dst, widget->button.text, window->x + x, window->y + y, w, h,
-              widget->button.color.text.r, widget->button.color.text.g,
-              widget->button.color.text.b, widget->button.color.text.a);
+  g_damage_widget(widget);
 }
-static void g_draw_widget_check_box(SDL_Surface *dst, const g_widget *widget)
+static void g_handle_widget_event_slider_v(g_widget *widget, const g_event *event, const int w, const int h)
 {
-  g_window *window = widget->window;
-  int x, y;
-  
-  g_adjust_widget_position_check_box(widget, &x, &y);
+  double old_value = widget->slider.value;
   
-  /* draw background */
-  boxRGBA(dst, window->x + x + 1, window->y + y + 1,
-          window->x + x + G_CHECK_BOX_SIZE - 1, window->y + y + G_CHECK_BOX_SIZE - 1,
-          widget->check.color.background.r, widget->check.color.background.g,
-          widget->check.color.background.b, widget->check.color.background.a);
+  (void)w;
   
-  /* draw frame */
-  rectangleRGBA(dst, window->x + x, window->y + y,
-          window->x + x + G_CHECK_BOX_SIZE, window->y + y + G_CHECK_BOX_SIZE,
-          widget->check.color.frame.r, widget->check.color.frame.g,
-          widget->check.color.frame.b, widget->check.color.frame.a);
+  if(event->type == G_MOUSE_MOTION)
+    return;
   
-  /* draw 'X' if check box is enabled */
-  if(widget->check.state)
+  if(event->type == G_CLICK_LEFT)
   {
-    characterRGBA(dst, window->x + x + 5, window->y + y + 5, 'X',
-    widget->check.color.mark.r, widget->check.color.mark.g,
-    widget->check.color.mark.b, widget->check.color.mark.a);
+    if(widget->slider.flags.invert)
+      widget->slider.value = widget->slider.max_value * ((float)event->y/(float)h);
+    else
+      widget->slider.value = widget->slider.max_value * ((float)(h - event->y)/(float)h);
+    
+    clicked_slider = widget;
   }
-}
-static void g_draw_widget_surface(SDL_Surface *dst, const g_widget *widget)
-{
-  g_window *window = widget->window;
-  SDL_Rect temp_src, temp_dst;
-  int x, y, w, h;
+  else if(widget->slider.flags.mouse_wheel && (event->type == G_WHEEL_UP || event->type == G_WHEEL_DOWN))
+    g_scroll_slider(widget, event->type);
   
-  g_adjust_widget_position_surface(widget, &x, &y, &w, &h);
+  if(widget->slider.value != old_value)
+    changed_widget = widget;
   
-  /* set temp_src x and y */
-  temp_src.x = widget->surface.src_x;
-  temp_src.y = widget->surface.src_y;
-  temp_src.w = w;
-  temp_src.h = h;
+  g_damage_widget(widget);
+}
+static void g_handle_widget_event_drop_down_list(g_widget *widget, const g_event *event, const int w, const int h)
+{
+  (void)h;
   
-  /* correct temp_dst */
-  temp_dst.x = window->x + x;
-  temp_dst.y = window->y + y;
+  if(event->type == G_MOUSE_MOTION)
+    return;
   
-  /* blit surface */
-  SDL_BlitSurface(widget->surface.surface, &temp_src, dst, &temp_dst);
+  if(event->type == G_CLICK_LEFT && event->x > w - G_DROP_DOWN_LIST_SIZE)
+  {
+    active_drop_down_list = widget;
+    g_damage_widget(widget);
+  }
+  else if(widget->drop_down.flags.mouse_wheel && event->x < w - G_DROP_DOWN_LIST_SIZE)
+  {
+    if(event->type == G_WHEEL_UP && widget->drop_down.current_item > 0)
+    {
+      widget->drop_down.current_item--;
+      changed_widget = widget;
+    }
+    else if(event->type == G_WHEEL_DOWN && widget->drop_down.current_item < widget->drop_down.max_item)
+    {
+      widget->drop_down.current_item++;
+      changed_widget = widget;
+    }
+    
+    g_damage_widget(widget);
+  }
 }
-static void g_draw_widget_slider_h(SDL_Surface *dst, const g_widget *widget)
+
+static void g_destroy_widget_text(g_widget *widget)
 {
-  g_window *window = widget->window;
-  int x, y, w;
-  int slider_value;
+  free(widget->text.text);
+}
+static void g_destroy_widget_input_box(g_widget *widget)
+{
+  free(widget->input.text);
+}
+static void g_destroy_widget_button(g_widget *widget)
+{
+  free(widget->button.text);
+}
+static void g_destroy_widget_drop_down_list(g_widget *widget)
+{
+  free(widget->drop_down.text);
+  free(widget->drop_down.items);
+}
+
+/* the built-in widget types; further types are added by g_register_widget_type() */
+static g_widget_class widget_classes[G_MAX_WIDGET_TYPES] = {
+  /* G_TYPE_TEXT */
+  {g_draw_widget_text, g_get_widget_area_text, g_get_widget_hit_area_text, NULL, g_destroy_widget_text},
+  /* G_TYPE_INPUT_BOX */
+  {g_draw_widget_input_box, g_get_widget_area_input_box, g_get_widget_hit_area_text,
+   g_handle_widget_event_input_box, g_destroy_widget_input_box},
+  /* G_TYPE_BUTTON */
+  {g_draw_widget_button, g_get_widget_area_button, g_get_widget_hit_area_button,
+   g_handle_widget_event_button, g_destroy_widget_button},
+  /* G_TYPE_CHECK_BOX */
+  {g_draw_widget_check_box, g_get_widget_area_check_box, g_get_widget_hit_area_check_box,
+   g_handle_widget_event_check_box, NULL},
+  /* G_TYPE_SURFACE */
+  {g_draw_widget_surface, g_get_widget_area_surface, g_get_widget_hit_area_surface, NULL, NULL},
+  /* G_TYPE_SLIDER_H */
+  {g_draw_widget_slider_h, g_get_widget_area_slider_h, g_get_widget_hit_area_slider_h,
+   g_handle_widget_event_slider_h, NULL},
+  /* G_TYPE_SLIDER_V */
+  {g_draw_widget_slider_v, g_get_widget_area_slider_v, g_get_widget_hit_area_slider_v,
+   g_handle_widget_event_slider_v, NULL},
+  /* G_TYPE_DROP_DOWN_LIST */
+  {g_draw_widget_drop_down_list, g_get_widget_area_drop_down_list, g_get_widget_hit_area_drop_down_list,
+   g_handle_widget_event_drop_down_list, g_destroy_widget_drop_down_list}
+};
+
+/* returns the queued call at 'position', counted from the oldest one */
+static struct g_queued_event *g_get_queued_event(const int position)
+{
+  return &event_queue[(event_queue_first + position) % event_queue_size];
+}
+/* makes room for one more queued call; returns 0 on failure */
+static int g_make_room_in_event_queue(void)
+{
+  struct g_queued_event *queue;
+  int counter, counter2;
+  int size;
   
-  g_adjust_widget_position_slider(widget, &x, &y, &w, NULL);
+  if(event_queue_amount < event_queue_size)
+    return 1;
+  
+  /* drop the oldest mouse motion call, or a call to a destroyed window/widget, and keep the order */
+  /* of the other calls. clicks, value changes and all other calls are never dropped */
+  for(counter = 0; counter < event_queue_amount; counter++)
+  {
+    if(g_get_queued_event(counter)->event.type == G_MOUSE_MOTION || !g_get_queued_event(counter)->window)
+    {
+      for(counter2 = counter; counter2 > 0; counter2--)
+        *g_get_queued_event(counter2) = *g_get_queued_event(counter2 - 1);
+      
+      event_queue_first = (event_queue_first + 1) % event_queue_size;
+      event_queue_amount--;
+      return 1;
+    }
+  }
   
-  /* draw line */
-  thickLineRGBA(dst, window->x + x, window->y + y + G_SLIDER_H/2,
-                window->x + x + w, window->y + y + G_SLIDER_H/2, G_SLIDER_THICKNESS,
-                widget->slider.color.line.r, widget->slider.color.line.g,
-                widget->slider.color.line.b, widget->slider.color.line.a);
+  size = event_queue_size ? event_queue_size * 2 : G_MAX_QUEUED_EVENTS;
+  queue = malloc(size * sizeof(struct g_queued_event));
+  if(!queue)
+    return 0;
   
-  if(widget->slider.flags.invert)
-    slider_value = (1 - widget->slider.value/widget->slider.max_value) * (w - G_SLIDER_W);
-  else
-    slider_value = (widget->slider.value/widget->slider.max_value) * (w - G_SLIDER_W);
+  for(counter = 0; counter < event_queue_amount; counter++)
+    queue[counter] = *g_get_queued_event(counter);
   
-  /* draw slider */
-  boxRGBA(dst, window->x + x + slider_value, window->y + y,
-          window->x + x + slider_value + G_SLIDER_W - 1, window->y + y + G_SLIDER_H - 1,
-          widget->slider.color.slider.r, widget->slider.color.slider.g,
-          widget->slider.color.slider.b, widget->slider.color.slider.a);
+  free(event_queue);
+  event_queue = queue;
+  event_queue_size = size;
+  event_queue_first = 0;
   
-  /* draw frame */
-  rectangleRGBA(dst, window->x + x + slider_value - 1, window->y + y - 1,
-                window->x + x + slider_value + G_SLIDER_W, window->y + y + G_SLIDER_H,
-                widget->slider.color.frame.r, widget->slider.color.frame.g,
-                widget->slider.color.frame.b, widget->slider.color.frame.a);
+  return 1;
 }
-static void g_draw_widget_slider_v(SDL_Surface *dst, const g_widget *widget)
+/* calls the event function of 'window' or 'widget', or queues the call in deferred mode */
+static void g_call_event_function(g_window *window, g_widget *widget, const g_event *event)
 {
-  g_window *window = widget->window;
-  int x, y, h;
-  int slider_value;
+  struct g_queued_event *queued;
+  SDL_Event wake_event;
   
-  g_adjust_widget_position_slider(widget, &x, &y, NULL, &h);
+  if(!defer_events)
+  {
+    if(widget)
+      widget->event_function(event, widget, widget->event_data);
+    else
+      window->event_function(event, window, window->event_data);
+    
+    return;
+  }
   
-  /* draw line */
-  thickLineRGBA(dst, window->x + x + G_SLIDER_H/2, window->y + y,
-                window->x + x + G_SLIDER_H/2, window->y + y + h, G_SLIDER_THICKNESS,
-                widget->slider.color.line.r, widget->slider.color.line.g,
-                widget->slider.color.line.b, widget->slider.color.line.a);
+  /* merge with the last queued call like merged mouse motion: the last position is used, and */
+  /* the differences of window moves and resizes are summed up */
+  if(event_queue_amount > 0)
+  {
+    queued = g_get_queued_event(event_queue_amount - 1);
+    
+    if(queued->window == window && queued->widget == widget && queued->event.type == event->type)
+    {
+      if(event->type == G_MOUSE_MOTION)
+      {
+        queued->event = *event;
+        return;
+      }
+      if(event->type == G_WINDOW_MOVE || event->type == G_WINDOW_RESIZE)
+      {
+        queued->event.x += event->x;
+        queued->event.y += event->y;
+        return;
+      }
+    }
+  }
   
-  if(widget->slider.flags.invert)
-    slider_value = (widget->slider.value/widget->slider.max_value) * (h - G_SLIDER_W);
-  else
-    slider_value = (1 - widget->slider.value/widget->slider.max_value) * (h - G_SLIDER_W);
+  /* the call gets lost only, if there is no memory left */
+  if(!g_make_room_in_event_queue())
+    return;
   
-  /* draw slider */
-  boxRGBA(dst, window->x + x, window->y + y + slider_value,
-          window->x + x + G_SLIDER_H - 1, window->y + y + slider_value + G_SLIDER_W - 1,
-          widget->slider.color.slider.r, widget->slider.color.slider.g,
-          widget->slider.color.slider.b, widget->slider.color.slider.a);
+  /* wake up SDL_WaitEvent(), so the program gets to call g_dispatch_events() */
+  if(event_queue_amount == 0)
+  {
+    wake_event.type = SDL_VIDEOEXPOSE;
+    SDL_PushEvent(&wake_event);
+  }
   
-  /* draw frame */
-  rectangleRGBA(dst, window->x + x - 1, window->y + y + slider_value - 1,
-                window->x + x + G_SLIDER_H, window->y + y + slider_value + G_SLIDER_W,
-                widget->slider.color.frame.r, widget->slider.color.frame.g,
-                widget->slider.color.frame.b, widget->slider.color.frame.a);
+  queued = g_get_queued_event(event_queue_amount);
+  queued->event = *event;
+  queued->window = window;
+  queued->widget = widget;
+  event_queue_amount++;
 }
-static void g_draw_widget_drop_down_list(SDL_Surface *dst, const g_widget *widget)
+static void g_call_window_function(g_window *window, const g_event *event)
 {
-  g_window *window = widget->window;
-  int x, y, w;
+  g_call_event_function(window, NULL, event);
+}
+static void g_call_widget_function(g_widget *widget, const g_event *event)
+{
+  g_call_event_function(widget->window, widget, event);
+}
+/* drops queued calls to a widget, or to a window and all its widgets, which get destroyed */
+static void g_forget_queued_events(const g_window *window, const g_widget *widget)
+{
+  struct g_queued_event *queued;
   int counter;
-  char *text;
-  char temp_string[G_TEXT_LENGTH] = {0};
   
-  g_adjust_widget_position_drop_down_list(widget, &x, &y, &w);
+  for(counter = 0; counter < event_queue_amount; counter++)
+  {
+    queued = g_get_queued_event(counter);
+    
+    if((widget && queued->widget == widget) ||
+       (!widget && queued->window == window))
+    {
+      queued->window = NULL;
+      queued->widget = NULL;
+    }
+  }
+}
+/* passes G_VALUE_CHANGED to the widget, which has been changed by the last event */
+static void g_send_value_changed(void)
+{
+  g_widget *widget = changed_widget;
+  g_event gui_event;
   
-  /* draw background */
-  boxRGBA(dst, window->x + x, window->y + y, window->x + x + w - 1, window->y + y + G_DROP_DOWN_LIST_SIZE - 1,
-          widget->drop_down.color.background.r, widget->drop_down.color.background.g,
-          widget->drop_down.color.background.b, widget->drop_down.color.background.a);
+  if(!widget)
+    return;
   
-  /* draw frame */
-  rectangleRGBA(dst, window->x + x - 1, window->y + y - 1, window->x + x + w,
-          window->y + y + G_DROP_DOWN_LIST_SIZE,
-          widget->drop_down.color.frame.r, widget->drop_down.color.frame.g,
-          widget->drop_down.color.frame.b, widget->drop_down.color.frame.a);
-  vlineRGBA(dst, window->x + x + w - G_DROP_DOWN_LIST_SIZE, window->y + y,
-            window->y + y + G_DROP_DOWN_LIST_SIZE - 1,
-            widget->drop_down.color.frame.r, widget->drop_down.color.frame.g,
-            widget->drop_down.color.frame.b, widget->drop_down.color.frame.a);
+  changed_widget = NULL;
   
-  /* draw arrow pointing down; character number '31' in "SDL_gfxPrimitivesfont.h" */
-  characterRGBA(dst, window->x + x + w - G_DROP_DOWN_LIST_SIZE + 7, window->y + y + 8, 31,
-                widget->drop_down.color.arrow.r, widget->drop_down.color.arrow.g,
-                widget->drop_down.color.arrow.b, widget->drop_down.color.arrow.a);
+  if(!widget->event_function || !(widget->event_mask & G_EVENT_MASK(G_VALUE_CHANGED)))
+    return;
   
-  /* check position of current text item */
-  counter = g_get_line(widget->drop_down.text, widget->drop_down.current_item);
-  if(counter >= 0)
-  {
-    strcpy(temp_string, &widget->drop_down.text[counter]);
-    
-    /* cut off other list items */
-    if((text = strchr(temp_string, '\n')))
-      temp_string[strlen(temp_string) - strlen(text)] = '\0';
-    
-    /* adjust position */
-    x += G_MARGIN;
-    y += G_MARGIN;
-    w -= G_MARGIN * 2 + G_DROP_DOWN_LIST_SIZE;
-    
-    g_draw_text(dst, temp_string, window->x + x,
-                window->y + y, w, G_CHAR_H,
-                widget->drop_down.color.text.r, widget->drop_down.color.text.g,
-                widget->drop_down.color.text.b, widget->drop_down.color.text.a);
-  }
+  gui_event.type = G_VALUE_CHANGED;
+  gui_event.x = 0;
+  gui_event.y = 0;
+  gui_event.key = SDLK_UNKNOWN;
+  
+  g_call_widget_function(widget, &gui_event);
 }
-
-static void g_draw_widget(SDL_Surface *dst, const g_widget *widget)
+/* sends the delayed change of a dragged slider, if its value differs from the last one sent */
+static void g_send_delayed_value_changed(void)
 {
-  /* return if widget is outside the window */
-  if((widget->x > widget->window->w - widget->window->margin) ||
-    (widget->y > widget->window->h - widget->window->margin))
+  if(!delayed_slider)
     return;
   
-  switch(widget->type)
+  if(delayed_slider->slider.value != delayed_slider_value)
   {
-    case G_TYPE_TEXT:
-      g_draw_widget_text(dst, widget);
-      break;
-    case G_TYPE_INPUT_BOX:
-      g_draw_widget_input_box(dst, widget);
-      break;
-    case G_TYPE_BUTTON:
-      g_draw_widget_button(dst, widget);
-      break;
-    case G_TYPE_CHECK_BOX:
-      g_draw_widget_check_box(dst, widget);
-      break;
-    case G_TYPE_SURFACE:
-      g_draw_widget_surface(dst, widget);
-      break;
-    case G_TYPE_SLIDER_H:
-      g_draw_widget_slider_h(dst, widget);
-      break;
-    case G_TYPE_SLIDER_V:
-      g_draw_widget_slider_v(dst, widget);
-      break;
-    case G_TYPE_DROP_DOWN_LIST:
-      g_draw_widget_drop_down_list(dst, widget);
-      break;
+    delayed_slider_value = delayed_slider->slider.value;
+    changed_widget = delayed_slider;
+    g_send_value_changed();
   }
 }
-
-/* window draw function */
-static void g_draw_window(SDL_Surface *dst, const g_window *window)
+/* sends G_MOUSE_LEAVE to the entered widget, if the mouse has moved away from it */
+static void g_leave_widget(const SDL_Event *event)
 {
-  g_widget *widget = NULL;
-  char temp_string[G_TEXT_LENGTH] = {0};
+  g_widget *widget = entered_widget;
+  g_event gui_event;
+  int x, y, w, h;
+  
+  if(!widget || event->type != SDL_MOUSEMOTION)
+    return;
   
-  int counter;
-  float r, g, b, a;
-  float r_step, g_step, b_step, a_step;
+  entered_widget = NULL;
   
-  /* return if window is not visible */
-  if(!window->flags.visible)
+  if(!widget->event_function || !(widget->event_mask & G_EVENT_MASK(G_MOUSE_LEAVE)))
     return;
   
-  /* draw title bar start */
-  if(window->flags.title_bar)
+  g_get_widget_hit_area(widget, &x, &y, &w, &h);
+  
+  gui_event.type = G_MOUSE_LEAVE;
+  gui_event.x = event->motion.x - widget->window->x - x;
+  gui_event.y = event->motion.y - widget->window->y - y;
+  gui_event.key = SDLK_UNKNOWN;
+  
+  g_call_widget_function(widget, &gui_event);
+}
+/* passes a mouse event at x/y inside the widget to its event function */
+/* mouse motion events are preceded by G_MOUSE_ENTER, if the mouse has just entered the widget */
+static void g_send_widget_mouse_event(g_widget *widget, g_event *gui_event, const SDL_Event *event, const int x, const int y)
+{
+  g_event enter_event;
+  
+  if(event->type == SDL_MOUSEMOTION && widget != entered_widget)
   {
-    /* reset colors */
-    r = window->color.title_bar_top.r;
-    g = window->color.title_bar_top.g;
-    b = window->color.title_bar_top.b;
-    a = window->color.title_bar_top.a;
-    
-    /* calculate color steps */
-    r_step = ((float)window->color.title_bar_top.r - (float)window->color.title_bar_bottom.r)/(float)G_WINDOW_TITLE_BAR_HEIGHT;
-    g_step = ((float)window->color.title_bar_top.g - (float)window->color.title_bar_bottom.g)/(float)G_WINDOW_TITLE_BAR_HEIGHT;
-    b_step = ((float)window->color.title_bar_top.b - (float)window->color.title_bar_bottom.b)/(float)G_WINDOW_TITLE_BAR_HEIGHT;
-    a_step = ((float)window->color.title_bar_top.a - (float)window->color.title_bar_bottom.a)/(float)G_WINDOW_TITLE_BAR_HEIGHT;
-    
-    /* draw tile bar background */
-    for(counter = window->y - G_WINDOW_TITLE_BAR_HEIGHT; counter < window->y - 1; counter++)
-    {
-      if(window->flags.close_button)
-        hlineRGBA(dst, window->x, window->x + window->w - G_WINDOW_CLOSE_BUTTON_WIDTH - 1, counter, r, g, b, a);
-      else
-        hlineRGBA(dst, window->x, window->x + window->w - 1, counter, r, g, b, a);
-      
-      r -= r_step;
-      g -= g_step;
-      b -= b_step;
-      a -= a_step;
-    }
-    
-    /* draw frame */
-    hlineRGBA(dst, window->x - 1, window->x + window->w, window->y - G_WINDOW_TITLE_BAR_HEIGHT - 1,
-              window->color.frame.r, window->color.frame.g, window->color.frame.b, window->color.frame.a);
-    vlineRGBA(dst, window->x - 1, window->y - 2, window->y - G_WINDOW_TITLE_BAR_HEIGHT,
-              window->color.frame.r, window->color.frame.g, window->color.frame.b, window->color.frame.a);
-    vlineRGBA(dst, window->x + window->w, window->y - G_WINDOW_TITLE_BAR_HEIGHT, window->y - 2,
-              window->color.frame.r, window->color.frame.g, window->color.frame.b, window->color.frame.a);
+    g_leave_widget(event);
+    entered_widget = widget;
     
-    /* draw close button */
-    if(window->flags.close_button)
+    if(widget->event_function && (widget->event_mask & G_EVENT_MASK(G_MOUSE_ENTER)))
     {
-      /* reset colors */
-      r = window->color.close_button_top.r;
-      g = window->color.close_button_top.g;
-      b = window->color.close_button_top.b;
-      a = window->color.close_button_top.a;
-      
-      /* calculate color steps */
-      r_step = ((float)window->color.close_button_top.r - (float)window->color.close_button_bottom.r)/(float)G_WINDOW_TITLE_BAR_HEIGHT;
-      g_step = ((float)window->color.close_button_top.g - (float)window->color.close_button_bottom.g)/(float)G_WINDOW_TITLE_BAR_HEIGHT;
-      b_step = ((float)window->color.close_button_top.b - (float)window->color.close_button_bottom.b)/(float)G_WINDOW_TITLE_BAR_HEIGHT;
-      a_step = ((float)window->color.close_button_top.a - (float)window->color.close_button_bottom.a)/(float)G_WINDOW_TITLE_BAR_HEIGHT;
+      enter_event.type = G_MOUSE_ENTER;
+      enter_event.x = x;
+      enter_event.y = y;
+      enter_event.key = SDLK_UNKNOWN;
       
-      /* draw close button background */
-      for(counter = window->y - G_WINDOW_TITLE_BAR_HEIGHT; counter < window->y - 1; counter++)
-      {
-        hlineRGBA(dst, window->x + window->w - G_WINDOW_CLOSE_BUTTON_WIDTH + 1,
-                  window->x + window->w - 1, counter, r, g, b, a);
-        
-        r -= r_step;
-        g -= g_step;
-        b -= b_step;
-        a -= a_step;
-      }
-      
-      /* draw frame */
-      vlineRGBA(dst, window->x + window->w - G_WINDOW_CLOSE_BUTTON_WIDTH, window->y - G_WINDOW_TITLE_BAR_HEIGHT,
-                window->y - 2, window->color.frame.r, window->color.frame.g,
-                window->color.frame.b, window->color.frame.a);
-      
-      /* write close button character */
-      characterRGBA(dst, window->x + window->w - G_WINDOW_CLOSE_BUTTON_WIDTH + G_MARGIN,
-                    window->y - G_WINDOW_TITLE_BAR_HEIGHT + G_MARGIN, window->close_button_character,
-                    window->color.close_button_text.r, window->color.close_button_text.g,
-                    window->color.close_button_text.b, window->color.close_button_text.a);
+      g_call_widget_function(widget, &enter_event);
       
-      /* calculate how much characters fit in title bar */
-      counter = (window->w - G_WINDOW_CLOSE_BUTTON_WIDTH - 2 * G_MARGIN)/G_CHAR_W;
-    }
-    else
-      counter = (window->w - 2 * G_MARGIN)/G_CHAR_W;
-    
-    /* text should fit in title bar */
-    if(strlen(window->title) > counter)
-    {
-      /* shorten text */
-      strncpy(temp_string, window->title, counter);
-      temp_string[counter - 3] = '.';
-      temp_string[counter - 2] = '.';
-      temp_string[counter - 1] = '.';
-      temp_string[counter] = '\0';
-    }
-    else
-      strcpy(temp_string, window->title);
-    
-    /* write text in center of title bar */
-    if(window->flags.close_button)
-    {
-      stringRGBA(dst, window->x + (window->w - G_WINDOW_CLOSE_BUTTON_WIDTH)/2 - (strlen(temp_string) * G_CHAR_W)/2,
-                 window->y - G_WINDOW_TITLE_BAR_HEIGHT + G_MARGIN, temp_string,
-                 window->color.title_text.r, window->color.title_text.g,
-                 window->color.title_text.b, window->color.title_text.a);
-    }
-    else
-    {
-      stringRGBA(dst, window->x + window->w/2 - (strlen(temp_string) * G_CHAR_W)/2,
-                 window->y - G_WINDOW_TITLE_BAR_HEIGHT + G_MARGIN, temp_string,
-                 window->color.title_text.r, window->color.title_text.g,
-                 window->color.title_text.b, window->color.title_text.a);
+      /* the event function has destroyed the widget */
+      if(entered_widget != widget)
+        return;
     }
   }
-  /* draw title bar end */
   
-  /* draw window body with frame */
-  boxRGBA(dst, window->x, window->y, window->x + window->w - 1, window->y + window->h - 1,
-          window->color.background.r, window->color.background.g,
-          window->color.background.b, window->color.background.a);
-  rectangleRGBA(dst, window->x - 1, window->y - 1, window->x + window->w, window->y + window->h, window->color.frame.r, window->color.frame.g, window->color.frame.b, window->color.frame.a);
+  if(!widget->event_function || !(widget->event_mask & G_EVENT_MASK(gui_event->type)))
+    return;
   
-  /* draw all widgets */
-  for(widget = window->first_widget; widget; widget = widget->next)
-    g_draw_widget(dst, widget);
+  gui_event->x = x;
+  gui_event->y = y;
   
-  /* draw resziable mark */
-  if(window->flags.resizable)
-  {
-    pixelRGBA(dst, window->x + window->w - 2, window->y + window->h - 2, window->color.resize_mark.r, window->color.resize_mark.g, window->color.resize_mark.b, window->color.resize_mark.a);
-    pixelRGBA(dst, window->x + window->w - 4, window->y + window->h - 4, window->color.resize_mark.r, window->color.resize_mark.g, window->color.resize_mark.b, window->color.resize_mark.a);
-    
-    pixelRGBA(dst, window->x + window->w - 4, window->y + window->h - 2, window->color.resize_mark.r, window->color.resize_mark.g, window->color.resize_mark.b, window->color.resize_mark.a);
-    pixelRGBA(dst, window->x + window->w - 6, window->y + window->h - 2, window->color.resize_mark.r, window->color.resize_mark.g, window->color.resize_mark.b, window->color.resize_mark.a);
-    pixelRGBA(dst, window->x + window->w - 6, window->y + window->h - 4, window->color.resize_mark.r, window->color.resize_mark.g, window->color.resize_mark.b, window->color.resize_mark.a);
-    pixelRGBA(dst, window->x + window->w - 8, window->y + window->h - 2, window->color.resize_mark.r, window->color.resize_mark.g, window->color.resize_mark.b, window->color.resize_mark.a);
-    
-    pixelRGBA(dst, window->x + window->w - 2, window->y + window->h - 4, window->color.resize_mark.r, window->color.resize_mark.g, window->color.resize_mark.b, window->color.resize_mark.a);
-    pixelRGBA(dst, window->x + window->w - 2, window->y + window->h - 6, window->color.resize_mark.r, window->color.resize_mark.g, window->color.resize_mark.b, window->color.resize_mark.a);
-    pixelRGBA(dst, window->x + window->w - 4, window->y + window->h - 6, window->color.resize_mark.r, window->color.resize_mark.g, window->color.resize_mark.b, window->color.resize_mark.a);
-    pixelRGBA(dst, window->x + window->w - 2, window->y + window->h - 8, window->color.resize_mark.r, window->color.resize_mark.g, window->color.resize_mark.b, window->color.resize_mark.a);
-  }
+  g_call_widget_function(widget, gui_event);
 }
-static int g_SDL_EventFilter(const SDL_Event *event)
+static int g_handle_event(const SDL_Event *event)
 {
   g_window *window = NULL;
   g_widget *widget = NULL;
+  struct g_widget_rect hit_area;
+  int *hit_cell, hit_index;
+  int hovering;
+  Uint32 changes;
   
   /* set event type to undefined and x to -1 */
   g_event gui_event;
   
   int x, y, w, h;
-  char buffer[G_TEXT_LENGTH] = {0};
+  double old_value;
+  int old_item;
   
   /* hide pop_up if cursor leaves it */
   if(selected_pop_up_window && event->type == SDL_MOUSEMOTION &&
@@ -922,7 +3456,7 @@ static int g_SDL_EventFilter(const SDL_Event *event)
   {
     if(moving_window)
     {
-      if(moving_window->event_function &&
+      if(moving_window->event_function && (moving_window->event_mask & G_EVENT_MASK(G_WINDOW_MOVE)) &&
          !(moving_window->x == temp_window_x &&
          moving_window->y == temp_window_y))
       {
@@ -930,7 +3464,7 @@ static int g_SDL_EventFilter(const SDL_Event *event)
         gui_event.x = moving_window->x - temp_window_x;
         gui_event.y = moving_window->y - temp_window_y;
         
-        moving_window->event_function(&gui_event, moving_window, moving_window->event_data);
+        g_call_window_function(moving_window, &gui_event);
       }
       
       moving_window = NULL;
@@ -939,7 +3473,7 @@ static int g_SDL_EventFilter(const SDL_Event *event)
     }
     else if(resizing_window)
     {
-      if(resizing_window->event_function &&
+      if(resizing_window->event_function && (resizing_window->event_mask & G_EVENT_MASK(G_WINDOW_RESIZE)) &&
          !(resizing_window->w == temp_window_w &&
          resizing_window->h == temp_window_h))
       {
@@ -947,7 +3481,7 @@ static int g_SDL_EventFilter(const SDL_Event *event)
         gui_event.x = resizing_window->w - temp_window_w;
         gui_event.y = resizing_window->h - temp_window_h;
         
-        resizing_window->event_function(&gui_event, resizing_window, resizing_window->event_data);
+        g_call_window_function(resizing_window, &gui_event);
       }
       
       resizing_window = NULL;
@@ -956,11 +3490,15 @@ static int g_SDL_EventFilter(const SDL_Event *event)
     }
     else if(clicked_button)
     {
+      g_damage_widget(clicked_button);
       clicked_button = NULL;
       return 0;
     }
     else if(clicked_slider)
     {
+      g_send_delayed_value_changed();
+      delayed_slider = NULL;
+      
       clicked_slider = NULL;
       return 0;
     }
@@ -969,16 +3507,16 @@ static int g_SDL_EventFilter(const SDL_Event *event)
   {
     if((event->type == SDL_KEYDOWN) || (event->type == SDL_KEYUP))
     {
-      if(grab_keyboard_window->event_function)
+      if(event->type == SDL_KEYDOWN)
+        gui_event.type = G_KEYDOWN;
+      else
+        gui_event.type = G_KEYUP;
+      
+      if(grab_keyboard_window->event_function && (grab_keyboard_window->event_mask & G_EVENT_MASK(gui_event.type)))
       {
-        if(event->type == SDL_KEYDOWN)
-          gui_event.type = G_KEYDOWN;
-        else if(event->type == SDL_KEYUP)
-          gui_event.type = G_KEYUP;
-        
         gui_event.key = event->key.keysym.sym;
         
-        grab_keyboard_window->event_function(&gui_event, grab_keyboard_window, grab_keyboard_window->event_data);
+        g_call_window_function(grab_keyboard_window, &gui_event);
       }
       
       return 0;
@@ -994,16 +3532,16 @@ static int g_SDL_EventFilter(const SDL_Event *event)
   {
     if((event->type == SDL_KEYDOWN) || (event->type == SDL_KEYUP))
     {
-      if(grab_keyboard_widget->event_function)
+      if(event->type == SDL_KEYDOWN)
+        gui_event.type = G_KEYDOWN;
+      else
+        gui_event.type = G_KEYUP;
+      
+      if(grab_keyboard_widget->event_function && (grab_keyboard_widget->event_mask & G_EVENT_MASK(gui_event.type)))
       {
-        if(event->type == SDL_KEYDOWN)
-          gui_event.type = G_KEYDOWN;
-        else if(event->type == SDL_KEYUP)
-          gui_event.type = G_KEYUP;
-        
         gui_event.key = event->key.keysym.sym;
         
-        grab_keyboard_widget->event_function(&gui_event, grab_keyboard_widget, grab_keyboard_widget->event_data);
+        g_call_widget_function(grab_keyboard_widget, &gui_event);
       }
       
       return 0;
@@ -1023,23 +3561,23 @@ static int g_SDL_EventFilter(const SDL_Event *event)
       {
         if(event->key.keysym.sym == SDLK_BACKSPACE && active_input_box->input.cursor_pos > 0)
         {
-          strcpy(buffer, active_input_box->input.text);
-          
-          active_input_box->input.text[active_input_box->input.cursor_pos - 1] = '\0';
-          
-          strcat(active_input_box->input.text, &buffer[active_input_box->input.cursor_pos]);
+          memmove(&active_input_box->input.text[active_input_box->input.cursor_pos - 1],
+                  &active_input_box->input.text[active_input_box->input.cursor_pos],
+                  strlen(active_input_box->input.text) - active_input_box->input.cursor_pos + 1);
           
           active_input_box->input.cursor_pos--;
           if(active_input_box->input.cursor_pos < active_input_box->input.first_character)
             active_input_box->input.first_character--;
+          
+          changed_widget = active_input_box;
         }
         else if(event->key.keysym.sym == SDLK_DELETE && active_input_box->input.cursor_pos < strlen(active_input_box->input.text))
         {
-          strcpy(buffer, active_input_box->input.text);
+          memmove(&active_input_box->input.text[active_input_box->input.cursor_pos],
+                  &active_input_box->input.text[active_input_box->input.cursor_pos + 1],
+                  strlen(active_input_box->input.text) - active_input_box->input.cursor_pos);
           
-          active_input_box->input.text[active_input_box->input.cursor_pos] = '\0';
-          
-          strcat(active_input_box->input.text, &buffer[active_input_box->input.cursor_pos + 1]);
+          changed_widget = active_input_box;
         }
         else if(event->key.keysym.sym == SDLK_LEFT && active_input_box->input.cursor_pos > 0)
         {
@@ -1087,31 +3625,35 @@ static int g_SDL_EventFilter(const SDL_Event *event)
                   ((event->key.keysym.unicode >= ' ' && event->key.keysym.unicode <= '/') ||
                   (event->key.keysym.unicode >= ':' && event->key.keysym.unicode <= '@') ||
                   (event->key.keysym.unicode >= '[' && event->key.keysym.unicode <= '`') ||
-                  (event->key.keysym.unicode >= '{' && event->key.keysym.unicode <= '~')))))
+                  (event->key.keysym.unicode >= '{' && event->key.keysym.unicode <= '~')))) &&
+                g_grow_input_box_text(active_input_box, strlen(active_input_box->input.text) + 1))
         {
-          strcpy(buffer, active_input_box->input.text);
+          memmove(&active_input_box->input.text[active_input_box->input.cursor_pos + 1],
+                  &active_input_box->input.text[active_input_box->input.cursor_pos],
+                  strlen(active_input_box->input.text) - active_input_box->input.cursor_pos + 1);
           
           active_input_box->input.text[active_input_box->input.cursor_pos] = event->key.keysym.unicode;
-          active_input_box->input.text[active_input_box->input.cursor_pos + 1] = '\0';
-          
-          strcat(active_input_box->input.text, &buffer[active_input_box->input.cursor_pos]);
           
           active_input_box->input.cursor_pos++;
           if(active_input_box->input.cursor_pos > active_input_box->input.first_character + active_input_box->input.char_amount)
             active_input_box->input.first_character++;
+          
+          changed_widget = active_input_box;
         }
+        
+        g_damage_widget(active_input_box);
       }
       
-      if(active_input_box->event_function)
+      if(event->type == SDL_KEYDOWN)
+        gui_event.type = G_KEYDOWN;
+      else
+        gui_event.type = G_KEYUP;
+      
+      if(active_input_box->event_function && (active_input_box->event_mask & G_EVENT_MASK(gui_event.type)))
       {
-        if(event->type == SDL_KEYDOWN)
-          gui_event.type = G_KEYDOWN;
-        else if(event->type == SDL_KEYUP)
-          gui_event.type = G_KEYUP;
-        
         gui_event.key = event->key.keysym.sym;
         
-        active_input_box->event_function(&gui_event, active_input_box, active_input_box->event_data);
+        g_call_widget_function(active_input_box, &gui_event);
       }
       
       return 0;
@@ -1124,6 +3666,7 @@ static int g_SDL_EventFilter(const SDL_Event *event)
       if(active_input_box->input.flags.key_repeat)
         SDL_EnableKeyRepeat(key_repeat_delay, key_repeat_interval);
       
+      g_damage_widget(active_input_box);
       active_input_box = NULL;
     }
   }
@@ -1142,15 +3685,26 @@ static int g_SDL_EventFilter(const SDL_Event *event)
       /* choose drop down list item and close it */
       if(event->type == SDL_MOUSEBUTTONDOWN && event->button.button == SDL_BUTTON_LEFT)
       {
+        old_item = active_drop_down_list->drop_down.current_item;
         active_drop_down_list->drop_down.current_item = (event->button.y - y)/G_CHAR_H;
         
+        if(active_drop_down_list->drop_down.current_item != old_item)
+          changed_widget = active_drop_down_list;
+        
+        g_damage_widget(active_drop_down_list);
         active_drop_down_list = NULL;
       }
+      else
+      {
+        /* the highlighted item follows the mouse */
+        g_damage_rect(x - 1, y, w + 2, h + 2);
+      }
       
       return 0;
     }
     else if(event->type == SDL_MOUSEBUTTONDOWN)
     {
+      g_damage_widget(active_drop_down_list);
       active_drop_down_list = NULL;
       
       return 0;
@@ -1160,13 +3714,19 @@ static int g_SDL_EventFilter(const SDL_Event *event)
   {
     if(moving_window)
     {
+      g_damage_window_area(moving_window);
+      
       moving_window->x += event->motion.xrel;
       moving_window->y += event->motion.yrel;
       
+      g_damage_window_area(moving_window);
+      
       return 0;
     }
     else if(resizing_window)
     {
+      g_damage_window(resizing_window);
+      
       if(resizing_window->flags.keep_ratio)
       {
         resizing_window->w += (event->motion.xrel + event->motion.yrel)/2;
@@ -1189,10 +3749,14 @@ static int g_SDL_EventFilter(const SDL_Event *event)
       else if(resizing_window->max_h > 0 && resizing_window->h > resizing_window->max_h)
         resizing_window->h = resizing_window->max_h;
       
+      g_damage_window(resizing_window);
+      
       return 0;
     }
     else if(clicked_slider)
     {
+      old_value = clicked_slider->slider.value;
+      
       if(clicked_slider->type == G_TYPE_SLIDER_H)
       {
         g_adjust_widget_position_slider(clicked_slider, &x, &y, &w, NULL);
@@ -1218,12 +3782,31 @@ static int g_SDL_EventFilter(const SDL_Event *event)
       else if(clicked_slider->slider.value > clicked_slider->slider.max_value)
         clicked_slider->slider.value = clicked_slider->slider.max_value;
       
+      if(clicked_slider->slider.flags.changes_per_frame)
+      {
+        /* sent with the next frame, see g_send_delayed_value_changed() */
+        if(!delayed_slider)
+        {
+          delayed_slider = clicked_slider;
+          delayed_slider_value = old_value;
+        }
+      }
+      else if(clicked_slider->slider.value != old_value)
+        changed_widget = clicked_slider;
+      
+      g_damage_widget(clicked_slider);
+      
       return 0;
     }
   }
   
+  /* most mouse motions stay on the same widget; skip the search in this case */
+  hovering = event->type == SDL_MOUSEMOTION && hover.window && g_hit_grid_is_current(hover.window) &&
+             event->motion.x >= hover.x1 && event->motion.x <= hover.x2 &&
+             event->motion.y >= hover.y1 && event->motion.y <= hover.y2;
+  
   /* check all windows */
-  for(window = last_window; window; window = window->prev)
+  for(window = hovering ? hover.window : last_window; window; window = window->prev)
   {
     /* check if event is inside a window */
     if(window->flags.visible &&
@@ -1244,521 +3827,273 @@ static int g_SDL_EventFilter(const SDL_Event *event)
       {
         if(event->type == SDL_MOUSEBUTTONDOWN && event->button.button == SDL_BUTTON_LEFT)
         {
-          /* check if close button was clicked */
-          if(window->flags.close_button && event->button.x > window->x + window->w - G_WINDOW_CLOSE_BUTTON_WIDTH)
-          {
-            /* call window event function */
-            if(window->event_function)
-            {
-              gui_event.type = G_WINDOW_CLOSE;
-              
-              window->event_function(&gui_event, window, window->event_data);
-            }
-          }
-          else if(window->flags.moveable)
-          {
-            temp_window_x = window->x;
-            temp_window_y = window->y;
-            
-            /* set window to moving_window */
-            moving_window = window;
-          }
-        }
-        
-        return 0;
-      }
-      
-      /* check if resize mark was clicked */
-      if(window->flags.resizable &&
-         event->button.button == SDL_BUTTON_LEFT &&
-         event->button.x < window->x + window->w &&
-         event->button.x > window->x + window->w - G_MARGIN &&
-         event->button.y < window->y + window->h &&
-         event->button.y > window->y + window->h - G_MARGIN)
-      {
-        temp_window_w = window->w;
-        temp_window_h = window->h;
-        
-        resizing_window = window;
-        
-        return 0;
-      }
-      
-      /* set mouse event type */
-      /* if this function has not returned already, */
-      /*the event will be checked if it matchs to any widget inside this window */
-      if(event->type == SDL_MOUSEMOTION)
-      {
-        gui_event.type = G_MOUSE_MOTION;
-      }
-      else
-      {
-        switch(event->button.button)
-        {
-          case SDL_BUTTON_LEFT:
-            gui_event.type = G_CLICK_LEFT;
-            break;
-          case SDL_BUTTON_MIDDLE:
-            gui_event.type = G_CLICK_MIDDLE;
-            break;
-          case SDL_BUTTON_RIGHT:
-            gui_event.type = G_CLICK_RIGHT;
-            break;
-          case SDL_BUTTON_WHEELUP:
-            gui_event.type = G_WHEEL_UP;
-            break;
-          case SDL_BUTTON_WHEELDOWN:
-            gui_event.type = G_WHEEL_DOWN;
-            break;
-          default:
-            gui_event.type = G_UNDEFINED;
-        }
-      }
-      
-      /* check each widget for collision */
-      for(widget = window->last_widget; widget; widget = widget->prev)
-      {
-        /* continue if widget is not in window w/h range */
-        if((widget->x > window->w - window->margin) || (widget->y > window->h - window->margin))
-          continue;
-        
-        if(widget->type == G_TYPE_TEXT)
-        {
-          g_adjust_widget_position(widget, &x, &y, &w, &h);
-          
-          /* check collision */
-          if(event->button.x > window->x + x &&
-             event->button.x < window->x + x + w &&
-             event->button.y > window->y + y &&
-             event->button.y < window->y + y + h)
-          {
-            /* mark widget pop_up as pop_up window */
-            if(widget->pop_up)
-            {
-              if(event->type == SDL_MOUSEMOTION)
-                g_mark_window_as_selected_pop_up(widget->pop_up, widget->pop_up_delay);
-              else
-                g_close_pop_up();
-            }
-            
-            /* call widget event function */
-            if(widget->event_function)
-            {
-              gui_event.x = event->button.x - window->x - x;
-              gui_event.y = event->button.y - window->y - y;
-              
-              widget->event_function(&gui_event, widget, widget->event_data);
-            }
-            
-            /* break out of widget loop, because event was processed */
-            break;
-          }
-        }
-        else if(widget->type == G_TYPE_INPUT_BOX)
-        {
-          g_adjust_widget_position(widget, &x, &y, &w, &h);
-          
-          /* check collision */
-          if(event->button.x > window->x + x &&
-             event->button.x < window->x + x + w &&
-             event->button.y > window->y + y &&
-             event->button.y < window->y + y + h)
-          {
-            if(event->type == SDL_MOUSEBUTTONDOWN &&
-               event->button.button == SDL_BUTTON_LEFT)
-            {
-              g_enter_input_box(widget);
-              
-              /* set horizontal cursor position */
-              active_input_box->input.cursor_pos = (event->button.x - window->x - x)/G_CHAR_W;
-              
-              if(active_input_box->input.cursor_pos > active_input_box->input.char_amount_w)
-                active_input_box->input.cursor_pos = active_input_box->input.char_amount_w;
-              
-              /* if input box has more then 1 lines */
-              if(h > G_INPUT_BOX_H)
-              {
-                active_input_box->input.cursor_pos += (event->button.y - window->y - y - G_CHAR_H)/G_CHAR_H * active_input_box->input.char_amount_w;
-                
-                if(event->button.y > window->y + y + G_MARGIN + G_CHAR_H &&
-                   event->button.x < window->x + x + G_MARGIN)
-                  active_input_box->input.cursor_pos++;
-                
-                if(active_input_box->input.cursor_pos > active_input_box->input.char_amount)
-                  active_input_box->input.cursor_pos -= active_input_box->input.char_amount_w;
-              }
-              
-              active_input_box->input.cursor_pos += widget->input.first_character;
-              if(active_input_box->input.cursor_pos > strlen(widget->input.text))
-                active_input_box->input.cursor_pos = strlen(widget->input.text);
-            }
-            
-            /* mark widget pop_up as pop_up window */
-            if(widget->pop_up && widget != active_input_box)
-            {
-              if(event->type == SDL_MOUSEMOTION)
-                g_mark_window_as_selected_pop_up(widget->pop_up, widget->pop_up_delay);
-              else
-                g_close_pop_up();
-            }
-            
-            /* call widget event function */
-            if(widget->event_function)
-            {
-              gui_event.x = event->button.x - window->x - x;
-              gui_event.y = event->button.y - window->y - y;
-              
-              widget->event_function(&gui_event, widget, widget->event_data);
-            }
-            
-            /* break out of widget loop, because event was processed */
-            break;
-          }
-        }
-        else if(widget->type == G_TYPE_BUTTON)
-        {
-          g_adjust_widget_position_button(widget, &x, &y, &w, &h);
-          
-          /* check collision */
-          if(event->button.x > window->x + x &&
-             event->button.x < window->x + x + w &&
-             event->button.y > window->y + y &&
-             event->button.y < window->y + y + h)
-          {
-            if(event->type == SDL_MOUSEBUTTONDOWN &&
-               event->button.button == SDL_BUTTON_LEFT)
-            {
-              clicked_button = widget;
-            }
-            
-            /* mark widget pop_up as pop_up window */
-            if(widget->pop_up)
-            {
-              if(event->type == SDL_MOUSEMOTION)
-                g_mark_window_as_selected_pop_up(widget->pop_up, widget->pop_up_delay);
-              else
-                g_close_pop_up();
-            }
-            
-            /* call widget event function */
-            if(widget->event_function)
-            {
-              gui_event.x = event->button.x - window->x - x;
-              gui_event.y = event->button.y - window->y - y;
-              
-              widget->event_function(&gui_event, widget, widget->event_data);
-            }
-            
-            /* break out of widget loop, because event was processed */
-            break;
-          }
-        }
-        else if(widget->type == G_TYPE_CHECK_BOX)
-        {
-          g_adjust_widget_position_check_box(widget, &x, &y);
-          
-          /* check collision */
-          if(event->button.x > window->x + x &&
-             event->button.x < window->x + x + G_CHECK_BOX_SIZE &&
-             event->button.y > window->y + y &&
-             event->button.y < window->y + y + G_CHECK_BOX_SIZE)
-          {
-            if(event->type == SDL_MOUSEBUTTONDOWN &&
-               event->button.button == SDL_BUTTON_LEFT)
-            {
-              if(widget->check.state)
-                widget->check.state = 0;
-              else
-                widget->check.state = 1;
-            }
-            
-            /* mark widget pop_up as pop_up window */
-            if(widget->pop_up)
-            {
-              if(event->type == SDL_MOUSEMOTION)
-                g_mark_window_as_selected_pop_up(widget->pop_up, widget->pop_up_delay);
-              else
-                g_close_pop_up();
-            }
-            
-            /* call widget event function */
-            if(widget->event_function)
-            {
-              gui_event.x = event->button.x - window->x - x;
-              gui_event.y = event->button.y - window->y - y;
-              
-              widget->event_function(&gui_event, widget, widget->event_data);
-            }
-            
-            /* break out of widget loop, because event was processed */
-            break;
-          }
-        }
-        else if(widget->type == G_TYPE_SURFACE)
-        {
-          g_adjust_widget_position_surface(widget, &x, &y, &w, &h);
-          
-          /* check collision */
-          if(event->button.x > window->x + x &&
-             event->button.x < window->x + x + w &&
-             event->button.y > window->y + y &&
-             event->button.y < window->y + y + h)
-          {
-            /* mark widget pop_up as pop_up window */
-            if(widget->pop_up)
-            {
-              if(event->type == SDL_MOUSEMOTION)
-                g_mark_window_as_selected_pop_up(widget->pop_up, widget->pop_up_delay);
-              else
-                g_close_pop_up();
-            }
-            
-            /* call widget event function */
-            if(widget->event_function)
-            {
-              gui_event.x = event->button.x - window->x - x;
-              gui_event.y = event->button.y - window->y - y;
-              
-              widget->event_function(&gui_event, widget, widget->event_data);
-            }
-            
-            /* break out of widget loop, because event was processed */
-            break;
-          }
-        }
-        else if(widget->type == G_TYPE_SLIDER_H)
-        {
-          g_adjust_widget_position_slider(widget, &x, &y, &w, NULL);
-          
-          /* check collision */
-          if(event->button.x > window->x + x &&
-             event->button.x < window->x + x + w &&
-             event->button.y > window->y + y &&
-             event->button.y < window->y + y + G_SLIDER_H)
+          /* check if close button was clicked */
+          if(window->flags.close_button && event->button.x > window->x + window->w - G_WINDOW_CLOSE_BUTTON_WIDTH)
           {
-            if(event->type == SDL_MOUSEBUTTONDOWN)
-            {
-              if(event->button.button == SDL_BUTTON_LEFT)
-              {
-                if(widget->slider.flags.invert)
-                  widget->slider.value = widget->slider.max_value * ((float)(w - (event->button.x - window->x - x))/(float)w);
-                else
-                  widget->slider.value = widget->slider.max_value * ((float)(event->button.x - window->x - x)/(float)w);
-                
-                clicked_slider = widget;
-              }
-              else if(widget->slider.flags.mouse_wheel)
-              {
-                if(event->button.button == SDL_BUTTON_WHEELUP)
-                {
-                  if(widget->slider.flags.invert)
-                    widget->slider.value -= widget->slider.max_value * G_SLIDER_MOUSEWHEEL_STEP;
-                  else
-                    widget->slider.value += widget->slider.max_value * G_SLIDER_MOUSEWHEEL_STEP;
-                  
-                  if(widget->slider.value < 0)
-                    widget->slider.value = 0;
-                  else if(widget->slider.value > widget->slider.max_value)
-                    widget->slider.value = widget->slider.max_value;
-                }
-                else if(event->button.button == SDL_BUTTON_WHEELDOWN)
-                {
-                  if(widget->slider.flags.invert)
-                    widget->slider.value += widget->slider.max_value * G_SLIDER_MOUSEWHEEL_STEP;
-                  else
-                    widget->slider.value -= widget->slider.max_value * G_SLIDER_MOUSEWHEEL_STEP;
-                  
-                  if(widget->slider.value < 0)
-                    widget->slider.value = 0;
-                  else if(widget->slider.value > widget->slider.max_value)
-                    widget->slider.value = widget->slider.max_value;
-                }
-              }
-            }
-            
-            /* mark widget pop_up as pop_up window */
-            if(widget->pop_up)
-            {
-              if(event->type == SDL_MOUSEMOTION)
-                g_mark_window_as_selected_pop_up(widget->pop_up, widget->pop_up_delay);
-              else
-                g_close_pop_up();
-            }
-            
-            /* call widget event function */
-            if(widget->event_function)
+            /* call window event function */
+            if(window->event_function && (window->event_mask & G_EVENT_MASK(G_WINDOW_CLOSE)))
             {
-              gui_event.x = event->button.x - window->x - x;
-              gui_event.y = event->button.y - window->y - y;
+              gui_event.type = G_WINDOW_CLOSE;
               
-              widget->event_function(&gui_event, widget, widget->event_data);
+              g_call_window_function(window, &gui_event);
             }
-            
-            /* break out of widget loop, because event was processed */
-            break;
           }
-        }
-        else if(widget->type == G_TYPE_SLIDER_V)
-        {
-          g_adjust_widget_position_slider(widget, &x, &y, NULL, &h);
-          
-          /* check collision */
-          if(event->button.x > window->x + x &&
-             event->button.x < window->x + x + G_SLIDER_H &&
-             event->button.y > window->y + y &&
-             event->button.y < window->y + y + h)
+          else if(window->flags.moveable)
           {
-            if(event->type == SDL_MOUSEBUTTONDOWN)
-            {
-              if(event->button.button == SDL_BUTTON_LEFT)
-              {
-                if(widget->slider.flags.invert)
-                  widget->slider.value = widget->slider.max_value * ((float)(event->button.y - window->y - y)/(float)h);
-                else
-                  widget->slider.value = widget->slider.max_value * ((float)(h - (event->button.y - window->y - y))/(float)h);
-                
-                clicked_slider = widget;
-              }
-              else if(widget->slider.flags.mouse_wheel)
-              {
-                if(event->button.button == SDL_BUTTON_WHEELUP)
-                {
-                  if(widget->slider.flags.invert)
-                    widget->slider.value -= widget->slider.max_value * G_SLIDER_MOUSEWHEEL_STEP;
-                  else
-                    widget->slider.value += widget->slider.max_value * G_SLIDER_MOUSEWHEEL_STEP;
-                  
-                  if(widget->slider.value < 0)
-                    widget->slider.value = 0;
-                  else if(widget->slider.value > widget->slider.max_value)
-                    widget->slider.value = widget->slider.max_value;
-                }
-                else if(event->button.button == SDL_BUTTON_WHEELDOWN)
-                {
-                  if(widget->slider.flags.invert)
-                    widget->slider.value += widget->slider.max_value * G_SLIDER_MOUSEWHEEL_STEP;
-                  else
-                    widget->slider.value -= widget->slider.max_value * G_SLIDER_MOUSEWHEEL_STEP;
-                  
-                  if(widget->slider.value < 0)
-                    widget->slider.value = 0;
-                  else if(widget->slider.value > widget->slider.max_value)
-                    widget->slider.value = widget->slider.max_value;
-                }
-              }
-            }
-            
-            /* mark widget pop_up as pop_up window */
-            if(widget->pop_up)
-            {
-              if(event->type == SDL_MOUSEMOTION)
-                g_mark_window_as_selected_pop_up(widget->pop_up, widget->pop_up_delay);
-              else
-                g_close_pop_up();
-            }
-            
-            /* call widget event function */
-            if(widget->event_function)
-            {
-              gui_event.x = event->button.x - window->x - x;
-              gui_event.y = event->button.y - window->y - y;
-              
-              widget->event_function(&gui_event, widget, widget->event_data);
-            }
+            temp_window_x = window->x;
+            temp_window_y = window->y;
             
-            /* break out of widget loop, because event was processed */
-            break;
+            /* set window to moving_window */
+            moving_window = window;
           }
         }
-        else if(widget->type == G_TYPE_DROP_DOWN_LIST && widget != active_drop_down_list)
+        
+        g_leave_widget(event);
+        
+        return 0;
+      }
+      
+      /* check if resize mark was clicked */
+      if(window->flags.resizable &&
+         event->button.button == SDL_BUTTON_LEFT &&
+         event->button.x < window->x + window->w &&
+         event->button.x > window->x + window->w - G_MARGIN &&
+         event->button.y < window->y + window->h &&
+         event->button.y > window->y + window->h - G_MARGIN)
+      {
+        temp_window_w = window->w;
+        temp_window_h = window->h;
+        
+        resizing_window = window;
+        
+        g_leave_widget(event);
+        
+        return 0;
+      }
+      
+      /* set mouse event type */
+      /* if this function has not returned already, */
+      /*the event will be checked if it matchs to any widget inside this window */
+      if(event->type == SDL_MOUSEMOTION)
+      {
+        gui_event.type = G_MOUSE_MOTION;
+      }
+      else
+      {
+        switch(event->button.button)
         {
-          g_adjust_widget_position_drop_down_list(widget, &x, &y, &w);
-          
-          /* check collision */
-          if(event->button.x > window->x + x &&
-             event->button.x < window->x + x + w &&
-             event->button.y > window->y + y &&
-             event->button.y < window->y + y + G_DROP_DOWN_LIST_SIZE)
-          {
-            if(event->type == SDL_MOUSEBUTTONDOWN)
-            {
-              if(event->button.button == SDL_BUTTON_LEFT &&
-                 event->button.x > window->x + x + w - G_DROP_DOWN_LIST_SIZE)
-              {
-                active_drop_down_list = widget;
-              }
-              else if(widget->drop_down.flags.mouse_wheel &&
-                      event->button.x < window->x + x + w - G_DROP_DOWN_LIST_SIZE)
-              {
-                if(event->button.button == SDL_BUTTON_WHEELUP &&
-                  widget->drop_down.current_item > 0)
-                {
-                  widget->drop_down.current_item--;
-                }
-                else if(event->button.button == SDL_BUTTON_WHEELDOWN &&
-                        widget->drop_down.current_item < widget->drop_down.max_item)
-                {
-                  widget->drop_down.current_item++;
-                }
-              }
-            }
-            
-            /* mark widget pop_up as pop_up window */
-            if(widget->pop_up)
-            {
-              if(event->type == SDL_MOUSEMOTION)
-                g_mark_window_as_selected_pop_up(widget->pop_up, widget->pop_up_delay);
-              else
-                g_close_pop_up();
-            }
-            
-            /* call widget event function */
-            if(widget->event_function)
-            {
-              gui_event.x = event->button.x - window->x - x;
-              gui_event.y = event->button.y - window->y - y;
-              
-              widget->event_function(&gui_event, widget, widget->event_data);
-            }
-            
-            /* break out of widget loop, because event was processed */
+          case SDL_BUTTON_LEFT:
+            gui_event.type = G_CLICK_LEFT;
             break;
-          }
+          case SDL_BUTTON_MIDDLE:
+            gui_event.type = G_CLICK_MIDDLE;
+            break;
+          case SDL_BUTTON_RIGHT:
+            gui_event.type = G_CLICK_RIGHT;
+            break;
+          case SDL_BUTTON_WHEELUP:
+            gui_event.type = G_WHEEL_UP;
+            break;
+          case SDL_BUTTON_WHEELDOWN:
+            gui_event.type = G_WHEEL_DOWN;
+            break;
+          default:
+            gui_event.type = G_UNDEFINED;
+        }
+      }
+      
+      /* only the widgets near the mouse need to be checked */
+      if(hovering)
+        hit_cell = hover.entries;
+      else
+        hit_cell = g_get_hit_grid_cell(window, event->button.x - window->x, event->button.y - window->y);
+      
+      changes = hover.changes;
+      
+      /* check the widgets for collision */
+      widget = g_find_widget(window, hit_cell, event->button.x - window->x, event->button.y - window->y,
+                             &hit_area, &hit_index);
+      if(widget)
+      {
+        gui_event.x = event->button.x - window->x - hit_area.x;
+        gui_event.y = event->button.y - window->y - hit_area.y;
+        
+        if(widget_classes[widget->type].handle_event)
+          widget_classes[widget->type].handle_event(widget, &gui_event, hit_area.w, hit_area.h);
+        
+        /* mark widget pop_up as pop_up window */
+        if(widget->pop_up && widget != active_input_box)
+        {
+          if(event->type == SDL_MOUSEMOTION)
+            g_mark_window_as_selected_pop_up(widget->pop_up, widget->pop_up_delay);
+          else
+            g_close_pop_up();
         }
+        
+        /* call widget event function */
+        g_send_widget_mouse_event(widget, &gui_event, event, gui_event.x, gui_event.y);
       }
       
+      /* remember the hit, unless a widget event function has changed anything */
+      if(event->type == SDL_MOUSEMOTION && !hovering && hit_cell &&
+         !active_drop_down_list && changes == hover.changes)
+        g_remember_hover(window, hit_cell, hit_index, event->motion.x, event->motion.y);
+      
       /* if this function has not returned already due to a title bar or resize event */
       /* an widget is pointing to NULL, it does mean that 'event' has been compared with all widgets */
       /* without finding any match. If the window has a event function, the event is passed to it */
-      if(!widget && window->event_function)
+      if(!widget)
+        g_leave_widget(event);
+      
+      if(!widget && window->event_function && (window->event_mask & G_EVENT_MASK(gui_event.type)))
       {
         /* set gui_event x/y to mouse position inside the window */
         gui_event.x = event->button.x - window->x;
         gui_event.y = event->button.y - window->y;
         
-        window->event_function(&gui_event, window, window->event_data);
+        g_call_window_function(window, &gui_event);
       }
       
       return 0;
     }
   }
   
+  g_leave_widget(event);
+  
   /* return 1 if event is not matching to any window/widget */
   /* and function has reached end */
   return 1;
 }
+static void g_flush_mouse_motion(void)
+{
+  SDL_Event event;
+  
+  if(!motion_pending)
+    return;
+  
+  motion_pending = 0;
+  event = pending_motion;
+  
+  /* pass the merged event to the program, if the gui does not use it */
+  if(g_handle_event(&event))
+    SDL_PushEvent(&event);
+  
+  g_send_value_changed();
+}
+static int g_filter_event(const SDL_Event *event)
+{
+  SDL_Event redraw_event;
+  int result;
+  
+  if(coalesce_motion && event->type == SDL_MOUSEMOTION)
+  {
+    if(motion_pending)
+    {
+      /* keep the last position and sum up the relative motion */
+      pending_motion.motion.state = event->motion.state;
+      pending_motion.motion.x = event->motion.x;
+      pending_motion.motion.y = event->motion.y;
+      pending_motion.motion.xrel += event->motion.xrel;
+      pending_motion.motion.yrel += event->motion.yrel;
+      
+      return 0;
+    }
+    
+    pending_motion = *event;
+    motion_pending = 1;
+    
+    /* wake up SDL_WaitEvent(), so the merged event gets handled by g_needs_redraw() */
+    redraw_event.type = SDL_VIDEOEXPOSE;
+    SDL_PushEvent(&redraw_event);
+    
+    return 0;
+  }
+  
+  /* keep the order of events */
+  g_flush_mouse_motion();
+  
+  result = g_handle_event(event);
+  g_send_value_changed();
+  
+  /* events used by the gui are dropped, so wake up SDL_WaitEvent() in another way */
+  if(!result && !redraw_event_pushed && (damage_everything || damage_rect_amount > 0))
+  {
+    redraw_event.type = SDL_VIDEOEXPOSE;
+    if(SDL_PushEvent(&redraw_event) == 0)
+      redraw_event_pushed = 1;
+  }
+  
+  return result;
+}
+/* stores an event for the drawing thread; called on SDL's event thread */
+static int g_pass_input_event(const SDL_Event *event)
+{
+  SDL_Event wake_event;
+  int write = __atomic_load_n(&input_queue_write, __ATOMIC_RELAXED);
+  int next = (write + 1) % G_MAX_INPUT_EVENTS;
+  
+  /* the queue is full, leave the event to the program */
+  if(next == __atomic_load_n(&input_queue_read, __ATOMIC_ACQUIRE))
+    return 1;
+  
+  /* the event must be stored, before the drawing thread can see it */
+  input_queue[write] = *event;
+  __atomic_store_n(&input_queue_write, next, __ATOMIC_RELEASE);
+  
+  /* wake up SDL_WaitEvent() once, until the drawing thread takes the events */
+  if(!__atomic_exchange_n(&input_wake_pushed, 1, __ATOMIC_ACQ_REL))
+  {
+    wake_event.type = SDL_VIDEOEXPOSE;
+    SDL_PushEvent(&wake_event);
+  }
+  
+  return 0;
+}
+/* handles the events passed by g_pass_input_event(); called on the drawing thread */
+static void g_handle_input_events(void)
+{
+  SDL_Event event;
+  int read = __atomic_load_n(&input_queue_read, __ATOMIC_RELAXED);
+  
+  __atomic_store_n(&input_wake_pushed, 0, __ATOMIC_SEQ_CST);
+  
+  while(read != __atomic_load_n(&input_queue_write, __ATOMIC_ACQUIRE))
+  {
+    event = input_queue[read];
+    
+    /* the event filter may overwrite the event, as soon as it is released */
+    read = (read + 1) % G_MAX_INPUT_EVENTS;
+    __atomic_store_n(&input_queue_read, read, __ATOMIC_RELEASE);
+    
+    /* pass the event to the program, if the gui does not use it */
+    if(g_filter_event(&event))
+      SDL_PushEvent(&event);
+  }
+}
+static int g_SDL_EventFilter(const SDL_Event *event)
+{
+  if(__atomic_load_n(&threaded_events, __ATOMIC_ACQUIRE))
+    return g_pass_input_event(event);
+  
+  return g_filter_event(event);
+}
 /* core functions end */
 
 /* widget functions start */
 g_widget *g_attach_text(g_window *window, const int x, const int y, const int w, const int h, const char *text)
 {
-  g_widget *widget = g_attach_raw_widged(window);
+  char *copy = g_copy_text(text);
+  g_widget *widget;
   
-  if(!widget)
+  if(!copy)
     return NULL;
   
-  /* set widget type */
-  widget->type = G_TYPE_TEXT;
+  widget = g_attach_raw_widged(window, G_TYPE_TEXT);
+  if(!widget)
+  {
+    free(copy);
+    return NULL;
+  }
   
   /* set coordinates */
   widget->x = x;
@@ -1766,32 +4101,27 @@ g_widget *g_attach_text(g_window *window, const int x, const int y, const int w,
   widget->w = w;
   widget->h = h;
   
-  /* copy text */
-  if(text)
-  {
-    strncpy(widget->text.text, text, G_TEXT_LENGTH);
-    widget->text.text[G_TEXT_LENGTH - 1] = '\0';
-  }
-  else
-    widget->text.text[0] = '\0';
+  widget->text.text = copy;
   
-  /* set colors to default */
-  widget->text.color.text.r = g_defaults.text.color.text.r;
-  widget->text.color.text.g = g_defaults.text.color.text.g;
-  widget->text.color.text.b = g_defaults.text.color.text.b;
-  widget->text.color.text.a = g_defaults.text.color.text.a;
+  /* use the colors of the theme */
+  widget->text.color = NULL;
   
   return widget;
 }
 g_widget *g_attach_input_box(g_window *window, const int x, const int y, const int w, const int h)
 {
-  g_widget *widget = g_attach_raw_widged(window);
+  char *copy = g_copy_text(NULL);
+  g_widget *widget;
   
-  if(!widget)
+  if(!copy)
     return NULL;
   
-  /* set widget type */
-  widget->type = G_TYPE_INPUT_BOX;
+  widget = g_attach_raw_widged(window, G_TYPE_INPUT_BOX);
+  if(!widget)
+  {
+    free(copy);
+    return NULL;
+  }
   
   /* set coordinates */
   widget->x = x;
@@ -1800,7 +4130,9 @@ g_widget *g_attach_input_box(g_window *window, const int x, const int y, const i
   widget->h = h;
   
   /* set widget specific stuff */
-  widget->input.text[0] = '\0';
+  widget->input.text = copy;
+  widget->input.text_size = 1;
+  widget->input.cursor_pos = 0;
   widget->input.first_character = 0;
   widget->input.limit = 0;
   
@@ -1817,90 +4149,44 @@ g_widget *g_attach_input_box(g_window *window, const int x, const int y, const i
   widget->input.flags.special_chars = g_defaults.input.flags.special_chars;
   widget->input.flags.key_repeat = g_defaults.input.flags.key_repeat;
   
-  /* set colors to default */
-  widget->input.color.text.r = g_defaults.input.color.text.r;
-  widget->input.color.text.g = g_defaults.input.color.text.g;
-  widget->input.color.text.b = g_defaults.input.color.text.b;
-  widget->input.color.text.a = g_defaults.input.color.text.a;
-  
-  widget->input.color.frame.r = g_defaults.input.color.frame.r;
-  widget->input.color.frame.g = g_defaults.input.color.frame.g;
-  widget->input.color.frame.b = g_defaults.input.color.frame.b;
-  widget->input.color.frame.a = g_defaults.input.color.frame.a;
-  
-  widget->input.color.background.r = g_defaults.input.color.background.r;
-  widget->input.color.background.g = g_defaults.input.color.background.g;
-  widget->input.color.background.b = g_defaults.input.color.background.b;
-  widget->input.color.background.a = g_defaults.input.color.background.a;
-  
-  widget->input.color.background_active.r = g_defaults.input.color.background_active.r;
-  widget->input.color.background_active.g = g_defaults.input.color.background_active.g;
-  widget->input.color.background_active.b = g_defaults.input.color.background_active.b;
-  widget->input.color.background_active.a = g_defaults.input.color.background_active.a;
-  
-  widget->input.color.cursor.r = g_defaults.input.color.cursor.r;
-  widget->input.color.cursor.g = g_defaults.input.color.cursor.g;
-  widget->input.color.cursor.b = g_defaults.input.color.cursor.b;
-  widget->input.color.cursor.a = g_defaults.input.color.cursor.a;
+  /* use the colors of the theme */
+  widget->input.color = NULL;
   
   return widget;
 }
 g_widget *g_attach_button(g_window *window, const int x, const int y, const char *text)
 {
-  g_widget *widget = g_attach_raw_widged(window);
+  char *copy = g_copy_text(text);
+  g_widget *widget;
   
-  if(!widget)
+  if(!copy)
     return NULL;
   
-  /* set widget type */
-  widget->type = G_TYPE_BUTTON;
+  widget = g_attach_raw_widged(window, G_TYPE_BUTTON);
+  if(!widget)
+  {
+    free(copy);
+    return NULL;
+  }
   
   /* set coordinates */
   widget->x = x;
   widget->y = y;
   
-  /* copy text */
-  if(text)
-  {
-    strncpy(widget->button.text, text, G_TEXT_LENGTH);
-    widget->button.text[G_TEXT_LENGTH - 1] = '\0';
-  }
-  else
-    widget->button.text[0] = '\0';
-  
-  /* set colors to default */
-  widget->button.color.text.r = g_defaults.button.color.text.r;
-  widget->button.color.text.g = g_defaults.button.color.text.g;
-  widget->button.color.text.b = g_defaults.button.color.text.b;
-  widget->button.color.text.a = g_defaults.button.color.text.a;
-  
-  widget->button.color.frame.r = g_defaults.button.color.frame.r;
-  widget->button.color.frame.g = g_defaults.button.color.frame.g;
-  widget->button.color.frame.b = g_defaults.button.color.frame.b;
-  widget->button.color.frame.a = g_defaults.button.color.frame.a;
+  widget->button.text = copy;
   
-  widget->button.color.top.r = g_defaults.button.color.top.r;
-  widget->button.color.top.g = g_defaults.button.color.top.g;
-  widget->button.color.top.b = g_defaults.button.color.top.b;
-  widget->button.color.top.a = g_defaults.button.color.top.a;
-  
-  widget->button.color.bottom.r = g_defaults.button.color.bottom.r;
-  widget->button.color.bottom.g = g_defaults.button.color.bottom.g;
-  widget->button.color.bottom.b = g_defaults.button.color.bottom.b;
-  widget->button.color.bottom.a = g_defaults.button.color.bottom.a;
+  /* use the colors of the theme */
+  widget->button.color = NULL;
   
   return widget;
 }
 g_widget *g_attach_check_box(g_window *window, const int x, const int y)
 {
-  g_widget *widget = g_attach_raw_widged(window);
+  g_widget *widget = g_attach_raw_widged(window, G_TYPE_CHECK_BOX);
   
   if(!widget)
     return NULL;
   
-  /* set widget type */
-  widget->type = G_TYPE_CHECK_BOX;
-  
   /* set coordinates */
   widget->x = x;
   widget->y = y;
@@ -1908,34 +4194,18 @@ g_widget *g_attach_check_box(g_window *window, const int x, const int y)
   /* widget specific stuff */
   widget->check.state = 0;
   
-  /* set colors to default */
-  widget->check.color.mark.r = g_defaults.check.color.mark.r;
-  widget->check.color.mark.g = g_defaults.check.color.mark.g;
-  widget->check.color.mark.b = g_defaults.check.color.mark.b;
-  widget->check.color.mark.a = g_defaults.check.color.mark.a;
-  
-  widget->check.color.frame.r = g_defaults.check.color.frame.r;
-  widget->check.color.frame.g = g_defaults.check.color.frame.g;
-  widget->check.color.frame.b = g_defaults.check.color.frame.b;
-  widget->check.color.frame.a = g_defaults.check.color.frame.a;
-  
-  widget->check.color.background.r = g_defaults.check.color.background.r;
-  widget->check.color.background.g = g_defaults.check.color.background.g;
-  widget->check.color.background.b = g_defaults.check.color.background.b;
-  widget->check.color.background.a = g_defaults.check.color.background.a;
+  /* use the colors of the theme */
+  widget->check.color = NULL;
   
   return widget;
 }
 g_widget *g_attach_surface(g_window *window, const int x, const int y, const int w, const int h, SDL_Surface *surface)
 {
-  g_widget *widget = g_attach_raw_widged(window);
+  g_widget *widget = g_attach_raw_widged(window, G_TYPE_SURFACE);
   
   if(!widget)
     return NULL;
   
-  /* set widget type */
-  widget->type = G_TYPE_SURFACE;
-  
   /* set coordinates */
   widget->x = x;
   widget->y = y;
@@ -1951,14 +4221,11 @@ g_widget *g_attach_surface(g_window *window, const int x, const int y, const int
 }
 g_widget *g_attach_slider_h(g_window *window, const int x, const int y, const int w, const double value, const double max_value)
 {
-  g_widget *widget = g_attach_slider_raw(window, value, max_value);
+  g_widget *widget = g_attach_slider_raw(window, G_TYPE_SLIDER_H, value, max_value);
   
   if(!widget)
     return NULL;
   
-  /* set widget type */
-  widget->type = G_TYPE_SLIDER_H;
-  
   /* set coordinates */
   widget->x = x;
   widget->y = y;
@@ -1968,14 +4235,11 @@ g_widget *g_attach_slider_h(g_window *window, const int x, const int y, const in
 }
 g_widget *g_attach_slider_v(g_window *window, const int x, const int y, const int h, const double value, const double max_value)
 {
-  g_widget *widget = g_attach_slider_raw(window, value, max_value);
+  g_widget *widget = g_attach_slider_raw(window, G_TYPE_SLIDER_V, value, max_value);
   
   if(!widget)
     return NULL;
   
-  /* set widget type */
-  widget->type = G_TYPE_SLIDER_V;
-  
   /* set coordinates */
   widget->x = x;
   widget->y = y;
@@ -1985,66 +4249,188 @@ g_widget *g_attach_slider_v(g_window *window, const int x, const int y, const in
 }
 g_widget *g_attach_drop_down_list(g_window *window, const int x, const int y, const int w, const char *text)
 {
-  g_widget *widget = g_attach_raw_widged(window);
+  g_widget *widget = g_attach_raw_widged(window, G_TYPE_DROP_DOWN_LIST);
   
   if(!widget)
     return NULL;
   
-  /* set widget type */
-  widget->type = G_TYPE_DROP_DOWN_LIST;
-  
   /* set coordinates */
   widget->x = x;
   widget->y = y;
   widget->w = w;
   
-  /* copy text */
-  if(text)
-  {
-    strncpy(widget->drop_down.text, text, G_TEXT_LENGTH);
-    widget->drop_down.text[G_TEXT_LENGTH - 1] = '\0';
-  }
-  else
-    widget->drop_down.text[0] = '\0';
+  /* copy text */
+  widget->drop_down.text = NULL;
+  widget->drop_down.items = NULL;
+  widget->drop_down.current_item = 0;
+  
+  if(!g_set_drop_down_list_text(widget, text))
+  {
+    g_destroy_widget(widget);
+    return NULL;
+  }
+  
+  /* widget specific stuff */
+  widget->drop_down.flags.mouse_wheel = g_defaults.drop_down.flags.mouse_wheel;
+  
+  /* use the colors of the theme */
+  widget->drop_down.color = NULL;
+  
+  return widget;
+}
+int g_set_drop_down_list_text(g_widget *widget, const char *text)
+{
+  struct g_drop_down_item *items;
+  char *new_text;
+  int counter, item, max_length;
+  
+  if(!(widget && widget->type == G_TYPE_DROP_DOWN_LIST))
+    return 0;
+  
+  if(!text)
+    text = "";
+  
+  new_text = malloc(strlen(text) + 1);
+  items = malloc(g_count_lines(text) * sizeof(struct g_drop_down_item));
+  if(!new_text || !items)
+  {
+    free(new_text);
+    free(items);
+    return 0;
+  }
+  
+  strcpy(new_text, text);
+  
+  /* build item index */
+  max_length = 1;
+  items[0].offset = 0;
+  for(counter = 0, item = 0; ; counter++)
+  {
+    if(new_text[counter] == '\n' || new_text[counter] == '\0')
+    {
+      items[item].length = counter - items[item].offset;
+      if(items[item].length > max_length)
+        max_length = items[item].length;
+      
+      if(new_text[counter] == '\0')
+        break;
+      
+      item++;
+      items[item].offset = counter + 1;
+    }
+  }
+  
+  /* damage the old list before replacing it */
+  if(widget->drop_down.text)
+    g_damage_widget(widget);
+  
+  free(widget->drop_down.text);
+  free(widget->drop_down.items);
+  
+  widget->drop_down.text = new_text;
+  widget->drop_down.items = items;
+  widget->drop_down.max_item = item;
+  widget->drop_down.max_length = max_length;
+  
+  if(widget->drop_down.current_item > widget->drop_down.max_item)
+    widget->drop_down.current_item = widget->drop_down.max_item;
+  
+  g_damage_widget(widget);
+  
+  return 1;
+}
+int g_set_widget_text(g_widget *widget, const char *text)
+{
+  char *new_text;
+  
+  if(!(widget && (widget->type == G_TYPE_TEXT || widget->type == G_TYPE_BUTTON || widget->type == G_TYPE_INPUT_BOX)))
+    return 0;
+  
+  new_text = g_copy_text(text);
+  if(!new_text)
+    return 0;
+  
+  /* damage the old text before replacing it */
+  g_damage_widget(widget);
+  
+  if(widget->type == G_TYPE_TEXT)
+  {
+    free(widget->text.text);
+    widget->text.text = new_text;
+  }
+  else if(widget->type == G_TYPE_BUTTON)
+  {
+    free(widget->button.text);
+    widget->button.text = new_text;
+  }
+  else
+  {
+    free(widget->input.text);
+    widget->input.text = new_text;
+    widget->input.text_size = strlen(new_text) + 1;
+    
+    widget->input.cursor_pos = 0;
+    widget->input.first_character = 0;
+  }
+  
+  g_damage_widget(widget);
+  
+  return 1;
+}
+g_widget *g_attach_custom_widget(g_window *window, const int type, const int x, const int y, const int w, const int h, void *data)
+{
+  g_widget *widget;
+  
+  if(type < G_TYPE_CUSTOM || type >= widget_type_amount)
+    return NULL;
+  
+  widget = g_attach_raw_widged(window, type);
+  if(!widget)
+    return NULL;
+  
+  widget->x = x;
+  widget->y = y;
+  widget->w = w;
+  widget->h = h;
+  
+  widget->custom = data;
   
-  /* widget specific stuff */
-  widget->drop_down.flags.mouse_wheel = g_defaults.drop_down.flags.mouse_wheel;
+  return widget;
+}
+int g_register_widget_type(const g_widget_class *widget_class)
+{
+  if(!widget_class || !widget_class->draw || !widget_class->get_area ||
+     widget_type_amount >= G_MAX_WIDGET_TYPES)
+    return -1;
   
-  widget->drop_down.current_item = 0;
-  widget->drop_down.max_item = g_count_lines(widget->drop_down.text) - 1;
-  
-  /* set colors to default */
-  widget->drop_down.color.text.r = g_defaults.drop_down.color.text.r;
-  widget->drop_down.color.text.g = g_defaults.drop_down.color.text.g;
-  widget->drop_down.color.text.b = g_defaults.drop_down.color.text.b;
-  widget->drop_down.color.text.a = g_defaults.drop_down.color.text.a;
-  
-  widget->drop_down.color.frame.r = g_defaults.drop_down.color.frame.r;
-  widget->drop_down.color.frame.g = g_defaults.drop_down.color.frame.g;
-  widget->drop_down.color.frame.b = g_defaults.drop_down.color.frame.b;
-  widget->drop_down.color.frame.a = g_defaults.drop_down.color.frame.a;
-  
-  widget->drop_down.color.background.r = g_defaults.drop_down.color.background.r;
-  widget->drop_down.color.background.g = g_defaults.drop_down.color.background.g;
-  widget->drop_down.color.background.b = g_defaults.drop_down.color.background.b;
-  widget->drop_down.color.background.a = g_defaults.drop_down.color.background.a;
-  
-  widget->drop_down.color.background_list.r = g_defaults.drop_down.color.background_list.r;
-  widget->drop_down.color.background_list.g = g_defaults.drop_down.color.background_list.g;
-  widget->drop_down.color.background_list.b = g_defaults.drop_down.color.background_list.b;
-  widget->drop_down.color.background_list.a = g_defaults.drop_down.color.background_list.a;
-  
-  widget->drop_down.color.highlight.r = g_defaults.drop_down.color.highlight.r;
-  widget->drop_down.color.highlight.g = g_defaults.drop_down.color.highlight.g;
-  widget->drop_down.color.highlight.b = g_defaults.drop_down.color.highlight.b;
-  widget->drop_down.color.highlight.a = g_defaults.drop_down.color.highlight.a;
-  
-  widget->drop_down.color.arrow.r = g_defaults.drop_down.color.arrow.r;
-  widget->drop_down.color.arrow.g = g_defaults.drop_down.color.arrow.g;
-  widget->drop_down.color.arrow.b = g_defaults.drop_down.color.arrow.b;
-  widget->drop_down.color.arrow.a = g_defaults.drop_down.color.arrow.a;
+  widget_classes[widget_type_amount] = *widget_class;
   
-  return widget;
+  return widget_type_amount++;
+}
+/* removes all references to the widget and frees its data, but not the widget itself */
+static void g_release_widget(g_widget *widget)
+{
+  if(widget == entered_widget)
+    entered_widget = NULL;
+  if(widget == changed_widget)
+    changed_widget = NULL;
+  if(widget == delayed_slider)
+    delayed_slider = NULL;
+  if(widget == clicked_button)
+    clicked_button = NULL;
+  if(widget == clicked_slider)
+    clicked_slider = NULL;
+  if(widget == active_input_box)
+    active_input_box = NULL;
+  if(widget == active_drop_down_list)
+    active_drop_down_list = NULL;
+  if(widget == grab_keyboard_widget)
+    grab_keyboard_widget = NULL;
+  
+  if(widget_classes[widget->type].destroy)
+    widget_classes[widget->type].destroy(widget);
+  
+  g_release_theme(widget->theme);
 }
 void g_destroy_widget(g_widget *widget)
 {
@@ -2053,6 +4439,12 @@ void g_destroy_widget(g_widget *widget)
   
   g_window *window = widget->window;
   
+  g_damage_widget(widget);
+  g_release_widget(widget);
+  g_forget_queued_events(window, widget);
+  
+  window->hit_grid.valid = 0;
+  
   if(widget == window->first_widget)
   {
     window->first_widget = widget->next;
@@ -2073,7 +4465,47 @@ void g_destroy_widget(g_widget *widget)
     widget->prev->next = widget->next;
   }
   
-  free(widget);
+  g_free_widget(widget);
+}
+
+void g_damage_widget(g_widget *widget)
+{
+  int x, y, w, h;
+  int counter;
+  
+  if(!widget)
+    return;
+  
+  widget->window->cache_valid = 0;
+  g_forget_hover();
+  
+  if(!widget->window->flags.visible)
+  {
+    widget->layout.valid = 0;
+    widget->window->hit_grid.valid = 0;
+    return;
+  }
+  
+  /* damage the old area, then recalculate the layout and damage the new area */
+  for(counter = 0; counter < 2; counter++)
+  {
+    if(counter == 1)
+      widget->layout.valid = 0;
+    
+    g_get_widget_area(widget, &x, &y, &w, &h);
+    g_damage_rect(widget->window->x + x, widget->window->y + y, w, h);
+    
+    /* the list of an active drop down list is drawn outside the window */
+    if(widget == active_drop_down_list)
+    {
+      g_adjust_widget_position_drop_down_list_size(widget, &x, &y, &w, &h);
+      g_damage_rect(x - 1, y, w + 2, h + 2);
+    }
+  }
+  
+  /* if the widget has moved, the grid is rebuilt with the next mouse event or redraw */
+  if(!g_hit_grid_matches_widget(widget->window, widget))
+    widget->window->hit_grid.valid = 0;
 }
 
 void g_enter_input_box(g_widget *widget)
@@ -2084,7 +4516,9 @@ void g_enter_input_box(g_widget *widget)
   int x, y, w, h;
   
   /* mark widget as current text box */
+  g_damage_widget(active_input_box);
   active_input_box = widget;
+  g_damage_widget(widget);
   
   /* adjust x, y, w and h */
   g_adjust_widget_position(widget, &x, &y, &w, &h);
@@ -2114,7 +4548,10 @@ void g_enter_input_box(g_widget *widget)
 void g_leave_input_box(void)
 {
   if(active_input_box)
+  {
+    g_damage_widget(active_input_box);
     active_input_box = NULL;
+  }
 }
 /* widget functions end */
 
@@ -2171,70 +4608,51 @@ g_window *g_create_window(const int x, const int y, const int w, const int h, co
   last_window->flags.moveable = g_defaults.window.flags.moveable;
   last_window->flags.resizable = g_defaults.window.flags.resizable;
   last_window->flags.keep_ratio = g_defaults.window.flags.keep_ratio;
+  last_window->flags.cached = g_defaults.window.flags.cached;
   
   last_window->close_button_character = g_defaults.window.close_button_character;
   last_window->margin = g_defaults.window.margin;
   
-  /* set window colors */
-  last_window->color.frame.r = g_defaults.window.color.frame.r;
-  last_window->color.frame.g = g_defaults.window.color.frame.g;
-  last_window->color.frame.b = g_defaults.window.color.frame.b;
-  last_window->color.frame.a = g_defaults.window.color.frame.a;
-  
-  last_window->color.background.r = g_defaults.window.color.background.r;
-  last_window->color.background.g = g_defaults.window.color.background.g;
-  last_window->color.background.b = g_defaults.window.color.background.b;
-  last_window->color.background.a = g_defaults.window.color.background.a;
-  
-  last_window->color.resize_mark.r = g_defaults.window.color.resize_mark.r;
-  last_window->color.resize_mark.g = g_defaults.window.color.resize_mark.g;
-  last_window->color.resize_mark.b = g_defaults.window.color.resize_mark.b;
-  last_window->color.resize_mark.a = g_defaults.window.color.resize_mark.a;
-  
-  last_window->color.title_text.r = g_defaults.window.color.title_text.r;
-  last_window->color.title_text.g = g_defaults.window.color.title_text.g;
-  last_window->color.title_text.b = g_defaults.window.color.title_text.b;
-  last_window->color.title_text.a = g_defaults.window.color.title_text.a;
-  
-  last_window->color.title_bar_top.r = g_defaults.window.color.title_bar_top.r;
-  last_window->color.title_bar_top.g = g_defaults.window.color.title_bar_top.g;
-  last_window->color.title_bar_top.b = g_defaults.window.color.title_bar_top.b;
-  last_window->color.title_bar_top.a = g_defaults.window.color.title_bar_top.a;
-  
-  last_window->color.title_bar_bottom.r = g_defaults.window.color.title_bar_bottom.r;
-  last_window->color.title_bar_bottom.g = g_defaults.window.color.title_bar_bottom.g;
-  last_window->color.title_bar_bottom.b = g_defaults.window.color.title_bar_bottom.b;
-  last_window->color.title_bar_bottom.a = g_defaults.window.color.title_bar_bottom.a;
-  
-  last_window->color.close_button_text.r = g_defaults.window.color.close_button_text.r;
-  last_window->color.close_button_text.g = g_defaults.window.color.close_button_text.g;
-  last_window->color.close_button_text.b = g_defaults.window.color.close_button_text.b;
-  last_window->color.close_button_text.a = g_defaults.window.color.close_button_text.a;
-  
-  last_window->color.close_button_top.r = g_defaults.window.color.close_button_top.r;
-  last_window->color.close_button_top.g = g_defaults.window.color.close_button_top.g;
-  last_window->color.close_button_top.b = g_defaults.window.color.close_button_top.b;
-  last_window->color.close_button_top.a = g_defaults.window.color.close_button_top.a;
-  
-  last_window->color.close_button_bottom.r = g_defaults.window.color.close_button_bottom.r;
-  last_window->color.close_button_bottom.g = g_defaults.window.color.close_button_bottom.g;
-  last_window->color.close_button_bottom.b = g_defaults.window.color.close_button_bottom.b;
-  last_window->color.close_button_bottom.a = g_defaults.window.color.close_button_bottom.a;
+  /* use the colors of the theme */
+  last_window->color = NULL;
+  last_window->theme = NULL;
+  last_window->is_pop_up = 0;
   
   /* widgets */
   last_window->first_widget = NULL;
   last_window->last_widget = NULL;
   
+  last_window->cache = NULL;
+  last_window->cache_valid = 0;
+  
+  last_window->hit_grid.valid = 0;
+  last_window->hit_grid.cells = NULL;
+  last_window->hit_grid.entries = NULL;
+  last_window->hit_grid.widgets = NULL;
+  last_window->hit_grid.areas = NULL;
+  last_window->hit_grid.hit_areas = NULL;
+  last_window->hit_grid.widget_amount = 0;
+  
+  last_window->widget_blocks = NULL;
+  last_window->unused_widgets = NULL;
+  
   last_window->event_function = NULL;
   last_window->event_data = NULL;
+  last_window->event_mask = g_defaults.window.event_mask;
+  
+  g_damage_window(last_window);
   
   return last_window;
 }
 void g_destroy_window(g_window *window)
 {
+  g_widget *widget;
+  
   if(!window)
     return;
   
+  g_damage_window(window);
+  
   if(window == first_window)
   {
     first_window = window->next;
@@ -2255,11 +4673,39 @@ void g_destroy_window(g_window *window)
     window->prev->next = window->next;
   }
   
-  /* destroy all widgets */
-  while(window->first_widget)
-    g_destroy_widget(window->first_widget);
+  /* destroy all widgets at once; the whole window is damaged already, except an open drop down list */
+  for(widget = window->first_widget; widget; widget = widget->next)
+  {
+    if(widget == active_drop_down_list)
+      g_damage_widget(widget);
+    
+    g_release_widget(widget);
+  }
+  
+  if(window == moving_window)
+    moving_window = NULL;
+  if(window == resizing_window)
+    resizing_window = NULL;
+  if(window == selected_pop_up_window)
+    selected_pop_up_window = NULL;
+  if(window == grab_keyboard_window)
+    grab_keyboard_window = NULL;
+  
+  g_free_widget_blocks(window);
+  g_forget_queued_events(window, NULL);
+  g_free_window_cache(window);
+  g_free_hit_grid(window);
+  g_release_theme(window->theme);
   free(window);
 }
+void g_damage_window(g_window *window)
+{
+  if(!window)
+    return;
+  
+  window->cache_valid = 0;
+  g_damage_window_area(window);
+}
 void g_raise_window(g_window *window)
 {
   if(!window)
@@ -2269,6 +4715,8 @@ void g_raise_window(g_window *window)
   if(window == last_window)
     return;
   
+  g_damage_window_area(window);
+  
   if(window->prev != NULL)
     window->prev->next = window->next;
   window->next->prev = window->prev;
@@ -2293,6 +4741,8 @@ void g_maximize_window_h(g_window *window)
   
   SDL_Surface *dst = SDL_GetVideoSurface();
   
+  g_damage_window(window);
+  
   /* set window w */
   window->w = dst->w;
   
@@ -2305,6 +4755,8 @@ void g_maximize_window_h(g_window *window)
     window->x = 0;
   else if(window->x + window->w > dst->w)
     window->x = dst->w - window->w;
+  
+  g_damage_window(window);
 }
 void g_maximize_window_v(g_window *window)
 {
@@ -2313,6 +4765,8 @@ void g_maximize_window_v(g_window *window)
   
   SDL_Surface *dst = SDL_GetVideoSurface();
   
+  g_damage_window(window);
+  
   /* set window h */
   window->h = dst->h;
   if(window->flags.title_bar)
@@ -2329,6 +4783,8 @@ void g_maximize_window_v(g_window *window)
     window->y = 0;
   else if(window->y + window->h > dst->h)
     window->y = dst->h - window->h;
+  
+  g_damage_window(window);
 }
 
 /* pop_up window functions */
@@ -2347,16 +4803,8 @@ g_window *g_create_pop_up_window(const int w, const int h)
   window->flags.resizable = 0;
   window->flags.keep_ratio = 0;
   
-  /* set colors */
-  window->color.frame.r = g_defaults.pop_up.color.frame.r;
-  window->color.frame.g = g_defaults.pop_up.color.frame.g;
-  window->color.frame.b = g_defaults.pop_up.color.frame.b;
-  window->color.frame.a = g_defaults.pop_up.color.frame.a;
-  
-  window->color.background.r = g_defaults.pop_up.color.background.r;
-  window->color.background.g = g_defaults.pop_up.color.background.g;
-  window->color.background.b = g_defaults.pop_up.color.background.b;
-  window->color.background.a = g_defaults.pop_up.color.background.a;
+  /* pop-up windows use their own colors of the theme */
+  window->is_pop_up = 1;
   
   return window;
 }
@@ -2389,27 +4837,305 @@ void g_open_pop_up(g_window *window)
     window->y = y + G_MARGIN - window->h;
   else
     window->y = y - G_MARGIN;
+  
+  g_damage_window_area(window);
 }
 void g_close_pop_up(void)
 {
   if(selected_pop_up_window)
   {
+    g_damage_window_area(selected_pop_up_window);
     selected_pop_up_window->flags.visible = 0;
     selected_pop_up_window = NULL;
   }
 }
 /* window functions end */
 
+/* theme functions start */
+g_theme *g_create_theme(void)
+{
+  g_theme *theme = malloc(sizeof(g_theme));
+  
+  if(!theme)
+    return NULL;
+  
+  *theme = *default_theme;
+  theme->references = 1;
+  
+  return theme;
+}
+void g_release_theme(g_theme *theme)
+{
+  if(!theme)
+    return;
+  
+  theme->references--;
+  if(theme->references == 0)
+    free(theme);
+}
+void g_reset_theme(g_theme *theme)
+{
+  /* window colors */
+  theme->window.frame.r = 80;
+  theme->window.frame.g = 80;
+  theme->window.frame.b = 80;
+  theme->window.frame.a = 200;
+  
+  theme->window.background.r = 50;
+  theme->window.background.g = 50;
+  theme->window.background.b = 50;
+  theme->window.background.a = 150;
+  
+  theme->window.resize_mark.r = 80;
+  theme->window.resize_mark.g = 80;
+  theme->window.resize_mark.b = 80;
+  theme->window.resize_mark.a = 255;
+  
+  theme->window.title_text.r = 180;
+  theme->window.title_text.g = 180;
+  theme->window.title_text.b = 180;
+  theme->window.title_text.a = 255;
+  
+  theme->window.title_bar_top.r = 81;
+  theme->window.title_bar_top.g = 81;
+  theme->window.title_bar_top.b = 81;
+  theme->window.title_bar_top.a = 255;
+  
+  theme->window.title_bar_bottom.r = 50;
+  theme->window.title_bar_bottom.g = 50;
+  theme->window.title_bar_bottom.b = 50;
+  theme->window.title_bar_bottom.a = 255;
+  
+  theme->window.close_button_text.r = 180;
+  theme->window.close_button_text.g = 180;
+  theme->window.close_button_text.b = 180;
+  theme->window.close_button_text.a = 255;
+  
+  theme->window.close_button_top.r = 81;
+  theme->window.close_button_top.g = 81;
+  theme->window.close_button_top.b = 81;
+  theme->window.close_button_top.a = 255;
+  
+  theme->window.close_button_bottom.r = 50;
+  theme->window.close_button_bottom.g = 50;
+  theme->window.close_button_bottom.b = 50;
+  theme->window.close_button_bottom.a = 255;
+  
+  /* text field */
+  theme->text.text.r = 180;
+  theme->text.text.g = 180;
+  theme->text.text.b = 180;
+  theme->text.text.a = 255;
+  
+  /* input box */
+  theme->input.text.r = 180;
+  theme->input.text.g = 180;
+  theme->input.text.b = 180;
+  theme->input.text.a = 255;
+  
+  theme->input.frame.r = 80;
+  theme->input.frame.g = 80;
+  theme->input.frame.b = 80;
+  theme->input.frame.a = 200;
+  
+  theme->input.background.r = 50;
+  theme->input.background.g = 50;
+  theme->input.background.b = 50;
+  theme->input.background.a = 150;
+  
+  theme->input.background_active.r = 20;
+  theme->input.background_active.g = 20;
+  theme->input.background_active.b = 20;
+  theme->input.background_active.a = 150;
+  
+  theme->input.cursor.r = 200;
+  theme->input.cursor.g = 200;
+  theme->input.cursor.b = 200;
+  theme->input.cursor.a = 255;
+  
+  /* button */
+  theme->button.text.r = 180;
+  theme->button.text.g = 180;
+  theme->button.text.b = 180;
+  theme->button.text.a = 255;
+  
+  theme->button.frame.r = 80;
+  theme->button.frame.g = 80;
+  theme->button.frame.b = 80;
+  theme->button.frame.a = 200;
+  
+  theme->button.top.r = 100;
+  theme->button.top.g = 100;
+  theme->button.top.b = 100;
+  theme->button.top.a = 255;
+  
+  theme->button.bottom.r = 80;
+  theme->button.bottom.g = 80;
+  theme->button.bottom.b = 80;
+  theme->button.bottom.a = 255;
+  
+  /* check box */
+  theme->check.mark.r = 180;
+  theme->check.mark.g = 180;
+  theme->check.mark.b = 180;
+  theme->check.mark.a = 255;
+  
+  theme->check.frame.r = 80;
+  theme->check.frame.g = 80;
+  theme->check.frame.b = 80;
+  theme->check.frame.a = 200;
+  
+  theme->check.background.r = 20;
+  theme->check.background.g = 20;
+  theme->check.background.b = 20;
+  theme->check.background.a = 150;
+  
+  /* slider */
+  theme->slider.slider.r = 20;
+  theme->slider.slider.g = 20;
+  theme->slider.slider.b = 20;
+  theme->slider.slider.a = 150;
+  
+  theme->slider.frame.r = 80;
+  theme->slider.frame.g = 80;
+  theme->slider.frame.b = 80;
+  theme->slider.frame.a = 200;
+  
+  theme->slider.line.r = 80;
+  theme->slider.line.g = 80;
+  theme->slider.line.b = 80;
+  theme->slider.line.a = 200;
+  
+  /* drop down list */
+  theme->drop_down.text.r = 180;
+  theme->drop_down.text.g = 180;
+  theme->drop_down.text.b = 180;
+  theme->drop_down.text.a = 255;
+  
+  theme->drop_down.frame.r = 80;
+  theme->drop_down.frame.g = 80;
+  theme->drop_down.frame.b = 80;
+  theme->drop_down.frame.a = 200;
+  
+  theme->drop_down.background.r = 50;
+  theme->drop_down.background.g = 50;
+  theme->drop_down.background.b = 50;
+  theme->drop_down.background.a = 150;
+  
+  theme->drop_down.background_list.r = 20;
+  theme->drop_down.background_list.g = 20;
+  theme->drop_down.background_list.b = 20;
+  theme->drop_down.background_list.a = 150;
+  
+  theme->drop_down.highlight.r = 80;
+  theme->drop_down.highlight.g = 80;
+  theme->drop_down.highlight.b = 80;
+  theme->drop_down.highlight.a = 200;
+  
+  theme->drop_down.arrow.r = 180;
+  theme->drop_down.arrow.g = 180;
+  theme->drop_down.arrow.b = 180;
+  theme->drop_down.arrow.a = 255;
+  
+  /* pop-up windows; they have no title bar, so only frame and background differ */
+  theme->pop_up = theme->window;
+  
+  theme->pop_up.frame.r = 80;
+  theme->pop_up.frame.g = 80;
+  theme->pop_up.frame.b = 80;
+  theme->pop_up.frame.a = 200;
+  
+  theme->pop_up.background.r = 50;
+  theme->pop_up.background.g = 50;
+  theme->pop_up.background.b = 50;
+  theme->pop_up.background.a = 150;
+}
+void g_set_window_theme(g_window *window, g_theme *theme)
+{
+  if(!window || window->theme == theme)
+    return;
+  
+  if(theme)
+    theme->references++;
+  
+  g_release_theme(window->theme);
+  window->theme = theme;
+  
+  g_damage_window(window);
+}
+void g_set_widget_theme(g_widget *widget, g_theme *theme)
+{
+  if(!widget || widget->theme == theme)
+    return;
+  
+  if(theme)
+    theme->references++;
+  
+  g_release_theme(widget->theme);
+  widget->theme = theme;
+  
+  g_damage_widget(widget);
+}
+g_theme *g_get_default_theme(void)
+{
+  return default_theme;
+}
+void g_set_default_theme(g_theme *theme)
+{
+  if(!theme || theme == default_theme)
+    return;
+  
+  theme->references++;
+  
+  g_release_theme(default_theme);
+  default_theme = theme;
+  
+  /* all windows without an own theme use the new one now */
+  g_damage_theme(theme);
+}
+void g_damage_theme(const g_theme *theme)
+{
+  g_window *window;
+  g_widget *widget;
+  
+  for(window = first_window; window; window = window->next)
+  {
+    /* this also covers the widgets, which use the theme of the window */
+    if(g_get_window_theme(window) == theme)
+    {
+      g_damage_window(window);
+      
+      if(active_drop_down_list && active_drop_down_list->window == window)
+        g_damage_widget(active_drop_down_list);
+      
+      continue;
+    }
+    
+    for(widget = window->first_widget; widget; widget = widget->next)
+    {
+      if(widget->theme == theme)
+        g_damage_widget(widget);
+    }
+  }
+}
+/* theme functions end */
+
 /* engine functions */
 int g_init_everything(void)
 {
   /* set defaults for the first time */
   g_reset_settings();
+  g_reset_theme(&builtin_theme);
+  
+  /* the engine keeps one reference to the built-in theme, so it is never freed */
+  builtin_theme.references = 2;
   
   /* SDL settings */
   SDL_EnableUNICODE(SDL_ENABLE);
   SDL_SetEventFilter(g_SDL_EventFilter);
   
+  g_damage_everything();
+  
   atexit(g_destroy_everything);
   return 1;
 }
@@ -2417,63 +5143,254 @@ void g_destroy_everything(void)
 {
   while(first_window)
     g_destroy_window(first_window);
+  
+  g_set_default_theme(&builtin_theme);
+  
+  motion_pending = 0;
+  
+  free(event_queue);
+  event_queue = NULL;
+  event_queue_size = 0;
+  event_queue_first = 0;
+  event_queue_amount = 0;
+  __atomic_store_n(&input_queue_read, __atomic_load_n(&input_queue_write, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+  
+  g_stop_render_threads();
+  g_free_glyph_sheets();
+  g_free_gradient_strips();
 }
 void g_draw_everything(SDL_Surface *dst)
 {
-  g_window *window = NULL;
+  SDL_Rect clip_rect;
+  
+  /* return if dest surface is NULL */
+  if(!dst)
+    return;
+  
+  g_handle_input_events();
+  g_flush_mouse_motion();
+  g_send_delayed_value_changed();
+  g_update_pop_up();
   
+  /* draw windows and the active drop down list, skipping parts hidden by other windows */
+  SDL_GetClipRect(dst, &clip_rect);
+  g_draw_regions(dst, &clip_rect, 1, 0);
+  SDL_SetClipRect(dst, &clip_rect);
+  
+  /* everything is up to date now */
+  damage_rect_amount = 0;
+  damage_everything = 0;
+  redraw_event_pushed = 0;
+}
+int g_draw_damaged(SDL_Surface *dst, SDL_Rect *rects, const int max)
+{
+  SDL_Rect clip_rect, *rect;
+  int counter, amount;
   int x, y, w, h;
-  int temp_x, temp_y;
   
   /* return if dest surface is NULL */
   if(!dst)
-    return;
+    return 0;
   
-  /* activate pop_up window */
-  if(selected_pop_up_window && !selected_pop_up_window->flags.visible &&
-     SDL_GetTicks() - selected_pop_up_timestop > selected_pop_up_delay)
-    g_open_pop_up(selected_pop_up_window);
+  g_handle_input_events();
+  g_flush_mouse_motion();
+  g_send_delayed_value_changed();
+  g_update_pop_up();
   
-  /* draw each window */
-  for(window = first_window; window; window = window->next)
-    g_draw_window(dst, window);
+  SDL_GetClipRect(dst, &clip_rect);
   
-  /* draw active drop down list */
-  if(active_drop_down_list)
+  if(damage_everything)
   {
-    g_adjust_widget_position_drop_down_list_size(active_drop_down_list, &x, &y, &w, &h);
-    
-    /* draw background */
-    boxRGBA(dst, x, y, x + w - 1, y + h,
-            active_drop_down_list->drop_down.color.background_list.r, active_drop_down_list->drop_down.color.background_list.g,
-            active_drop_down_list->drop_down.color.background_list.b, active_drop_down_list->drop_down.color.background_list.a);
+    damage_rects[0] = clip_rect;
+    damage_rect_amount = 1;
+  }
+  
+  /* cut off regions outside the clip rect of dst */
+  amount = 0;
+  for(counter = 0; counter < damage_rect_amount; counter++)
+  {
+    rect = &damage_rects[counter];
     
-    /* draw frame */
-    rectangleRGBA(dst, x - 1, y, x + w, y + h + 1,
-                  active_drop_down_list->drop_down.color.frame.r, active_drop_down_list->drop_down.color.frame.g,
-                  active_drop_down_list->drop_down.color.frame.b, active_drop_down_list->drop_down.color.frame.a);
+    x = (rect->x > clip_rect.x) ? rect->x : clip_rect.x;
+    y = (rect->y > clip_rect.y) ? rect->y : clip_rect.y;
+    w = ((rect->x + rect->w < clip_rect.x + clip_rect.w) ? rect->x + rect->w : clip_rect.x + clip_rect.w) - x;
+    h = ((rect->y + rect->h < clip_rect.y + clip_rect.h) ? rect->y + rect->h : clip_rect.y + clip_rect.h) - y;
     
-    /* highlight current item */
-    SDL_GetMouseState(&temp_x, &temp_y);
-    if(temp_x > x && temp_x < x + w && temp_y > y && temp_y < y + h)
+    if(w > 0 && h > 0)
+    {
+      damage_rects[amount].x = x;
+      damage_rects[amount].y = y;
+      damage_rects[amount].w = w;
+      damage_rects[amount].h = h;
+      amount++;
+    }
+  }
+  
+  /* merge all regions, if they dont fit into 'rects' */
+  if(amount > max && max > 0)
+  {
+    for(counter = 1; counter < amount; counter++)
     {
-      boxRGBA(dst, x, y + ((temp_y - y)/G_CHAR_H) * G_CHAR_H + 1,
-              x + w - 1, y + ((temp_y - y)/G_CHAR_H) * G_CHAR_H + G_CHAR_H,
-              active_drop_down_list->drop_down.color.highlight.r, active_drop_down_list->drop_down.color.highlight.g,
-              active_drop_down_list->drop_down.color.highlight.b, active_drop_down_list->drop_down.color.highlight.a);
+      rect = &damage_rects[counter];
+      
+      x = (rect->x < damage_rects[0].x) ? rect->x : damage_rects[0].x;
+      y = (rect->y < damage_rects[0].y) ? rect->y : damage_rects[0].y;
+      w = ((rect->x + rect->w > damage_rects[0].x + damage_rects[0].w) ? rect->x + rect->w : damage_rects[0].x + damage_rects[0].w) - x;
+      h = ((rect->y + rect->h > damage_rects[0].y + damage_rects[0].h) ? rect->y + rect->h : damage_rects[0].y + damage_rects[0].h) - y;
+      
+      damage_rects[0].x = x;
+      damage_rects[0].y = y;
+      damage_rects[0].w = w;
+      damage_rects[0].h = h;
     }
     
-    /* adjust position */
-    x += G_MARGIN;
-    y += G_MARGIN/2;
-    w -= G_MARGIN;
-    h += G_MARGIN/2;
+    amount = 1;
+  }
+  
+  /* redraw each region */
+  g_draw_regions(dst, damage_rects, amount, 1);
+  
+  for(counter = 0; rects && counter < amount && counter < max; counter++)
+    rects[counter] = damage_rects[counter];
+  
+  SDL_SetClipRect(dst, &clip_rect);
+  
+  /* everything is up to date now */
+  damage_rect_amount = 0;
+  damage_everything = 0;
+  redraw_event_pushed = 0;
+  
+  if(amount > max)
+    return (max > 0) ? max : 0;
+  
+  return amount;
+}
+void g_damage_everything(void)
+{
+  damage_everything = 1;
+  damage_rect_amount = 0;
+}
+int g_needs_redraw(void)
+{
+  g_handle_input_events();
+  
+  /* the merged mouse motion may change something */
+  g_flush_mouse_motion();
+  g_send_delayed_value_changed();
+  
+  /* a pop-up window, which is due now, must be drawn */
+  g_update_pop_up();
+  
+  return damage_everything || damage_rect_amount > 0;
+}
+int g_get_redraw_timeout(void)
+{
+  Uint32 time;
+  
+  if(g_needs_redraw())
+    return 0;
+  
+  /* wait for the pending pop-up window */
+  if(selected_pop_up_window && !selected_pop_up_window->flags.visible)
+  {
+    time = SDL_GetTicks() - selected_pop_up_timestop;
+    
+    return (time > selected_pop_up_delay) ? 0 : selected_pop_up_delay - time + 1;
+  }
+  
+  return -1;
+}
+void g_set_background_function(void (*function)(SDL_Surface *, const SDL_Rect *, void *), void *data)
+{
+  background_function = function;
+  background_data = data;
+}
+int g_set_render_threads(const int amount)
+{
+  int counter;
+  
+  g_stop_render_threads();
+  
+  /* glyph sheets are encoded differently with and without render threads */
+  g_free_glyph_sheets();
+  
+  if(amount < 2)
+    return 1;
+  
+  render_start = SDL_CreateSemaphore(0);
+  render_done = SDL_CreateSemaphore(0);
+  render_lock = SDL_CreateMutex();
+  if(!render_start || !render_done || !render_lock)
+  {
+    g_stop_render_threads();
+    return 1;
+  }
+  
+  /* the calling thread draws tiles too */
+  for(counter = 1; counter < amount && counter < G_MAX_RENDER_THREADS; counter++)
+  {
+    render_threads[render_thread_amount] = SDL_CreateThread(g_render_thread, &render_targets[counter]);
+    if(!render_threads[render_thread_amount])
+      break;
+    
+    render_thread_amount++;
+  }
+  
+  return render_thread_amount + 1;
+}
+void g_set_motion_coalescing(const int enable)
+{
+  if(!enable)
+    g_flush_mouse_motion();
+  
+  coalesce_motion = enable;
+}
+void g_set_deferred_events(const int enable)
+{
+  defer_events = enable;
+  
+  if(!enable)
+    g_dispatch_events();
+}
+void g_set_threaded_events(const int enable)
+{
+  __atomic_store_n(&threaded_events, enable, __ATOMIC_RELEASE);
+  
+  if(!enable)
+    g_handle_input_events();
+}
+int g_dispatch_events(void)
+{
+  g_event event;
+  g_window *window;
+  g_widget *widget;
+  int amount = 0;
+  
+  g_handle_input_events();
+  
+  /* event functions may queue further calls, or destroy windows/widgets of queued calls */
+  while(event_queue_amount > 0)
+  {
+    event = event_queue[event_queue_first].event;
+    window = event_queue[event_queue_first].window;
+    widget = event_queue[event_queue_first].widget;
+    
+    event_queue_first = (event_queue_first + 1) % event_queue_size;
+    event_queue_amount--;
     
-    /* draw text */
-    g_draw_text(dst, active_drop_down_list->drop_down.text, x, y, w, h,
-                active_drop_down_list->drop_down.color.text.r, active_drop_down_list->drop_down.color.text.g,
-                active_drop_down_list->drop_down.color.text.b, active_drop_down_list->drop_down.color.text.a);
+    if(widget && widget->event_function)
+    {
+      widget->event_function(&event, widget, widget->event_data);
+      amount++;
+    }
+    else if(!widget && window && window->event_function)
+    {
+      window->event_function(&event, window, window->event_data);
+      amount++;
+    }
   }
+  
+  return amount;
 }
 void g_reset_settings(void)
 {
@@ -2491,64 +5408,14 @@ void g_reset_settings(void)
   g_defaults.window.flags.moveable = 1;
   g_defaults.window.flags.resizable = 0;
   g_defaults.window.flags.keep_ratio = 0;
+  g_defaults.window.flags.cached = 0;
   
   /* window properties */
   g_defaults.window.close_button_character = 'X';
   g_defaults.window.margin = 8;
-  
-  /* window colors */
-  g_defaults.window.color.frame.r = 80;
-  g_defaults.window.color.frame.g = 80;
-  g_defaults.window.color.frame.b = 80;
-  g_defaults.window.color.frame.a = 200;
-  
-  g_defaults.window.color.background.r = 50;
-  g_defaults.window.color.background.g = 50;
-  g_defaults.window.color.background.b = 50;
-  g_defaults.window.color.background.a = 150;
-  
-  g_defaults.window.color.resize_mark.r = 80;
-  g_defaults.window.color.resize_mark.g = 80;
-  g_defaults.window.color.resize_mark.b = 80;
-  g_defaults.window.color.resize_mark.a = 255;
-  
-  g_defaults.window.color.title_text.r = 180;
-  g_defaults.window.color.title_text.g = 180;
-  g_defaults.window.color.title_text.b = 180;
-  g_defaults.window.color.title_text.a = 255;
-  
-  g_defaults.window.color.title_bar_top.r = 81;
-  g_defaults.window.color.title_bar_top.g = 81;
-  g_defaults.window.color.title_bar_top.b = 81;
-  g_defaults.window.color.title_bar_top.a = 255;
-  
-  g_defaults.window.color.title_bar_bottom.r = 50;
-  g_defaults.window.color.title_bar_bottom.g = 50;
-  g_defaults.window.color.title_bar_bottom.b = 50;
-  g_defaults.window.color.title_bar_bottom.a = 255;
-  
-  g_defaults.window.color.close_button_text.r = 180;
-  g_defaults.window.color.close_button_text.g = 180;
-  g_defaults.window.color.close_button_text.b = 180;
-  g_defaults.window.color.close_button_text.a = 255;
-  
-  g_defaults.window.color.close_button_top.r = 81;
-  g_defaults.window.color.close_button_top.g = 81;
-  g_defaults.window.color.close_button_top.b = 81;
-  g_defaults.window.color.close_button_top.a = 255;
-  
-  g_defaults.window.color.close_button_bottom.r = 50;
-  g_defaults.window.color.close_button_bottom.g = 50;
-  g_defaults.window.color.close_button_bottom.b = 50;
-  g_defaults.window.color.close_button_bottom.a = 255;
+  g_defaults.window.event_mask = G_EVENT_MASK_ALL;
   
   /* widget defaults */
-  /* text field */
-  g_defaults.text.color.text.r = 180;
-  g_defaults.text.color.text.g = 180;
-  g_defaults.text.color.text.b = 180;
-  g_defaults.text.color.text.a = 255;
-  
   /* input box */
   g_defaults.input.replace_character = '*';
   
@@ -2563,132 +5430,18 @@ void g_reset_settings(void)
   g_defaults.input.flags.special_chars = 1;
   g_defaults.input.flags.key_repeat = 1;
   
-  g_defaults.input.color.text.r = 180;
-  g_defaults.input.color.text.g = 180;
-  g_defaults.input.color.text.b = 180;
-  g_defaults.input.color.text.a = 255;
-  
-  g_defaults.input.color.frame.r = 80;
-  g_defaults.input.color.frame.g = 80;
-  g_defaults.input.color.frame.b = 80;
-  g_defaults.input.color.frame.a = 200;
-  
-  g_defaults.input.color.background.r = 50;
-  g_defaults.input.color.background.g = 50;
-  g_defaults.input.color.background.b = 50;
-  g_defaults.input.color.background.a = 150;
-  
-  g_defaults.input.color.background_active.r = 20;
-  g_defaults.input.color.background_active.g = 20;
-  g_defaults.input.color.background_active.b = 20;
-  g_defaults.input.color.background_active.a = 150;
-  
-  g_defaults.input.color.cursor.r = 200;
-  g_defaults.input.color.cursor.g = 200;
-  g_defaults.input.color.cursor.b = 200;
-  g_defaults.input.color.cursor.a = 255;
-  
-  /* button */
-  g_defaults.button.color.text.r = 180;
-  g_defaults.button.color.text.g = 180;
-  g_defaults.button.color.text.b = 180;
-  g_defaults.button.color.text.a = 255;
-  
-  g_defaults.button.color.frame.r = 80;
-  g_defaults.button.color.frame.g = 80;
-  g_defaults.button.color.frame.b = 80;
-  g_defaults.button.color.frame.a = 200;
-  
-  g_defaults.button.color.top.r = 100;
-  g_defaults.button.color.top.g = 100;
-  g_defaults.button.color.top.b = 100;
-  g_defaults.button.color.top.a = 255;
-  
-  g_defaults.button.color.bottom.r = 80;
-  g_defaults.button.color.bottom.g = 80;
-  g_defaults.button.color.bottom.b = 80;
-  g_defaults.button.color.bottom.a = 255;
-  
-  /* check box */
-  g_defaults.check.color.mark.r = 180;
-  g_defaults.check.color.mark.g = 180;
-  g_defaults.check.color.mark.b = 180;
-  g_defaults.check.color.mark.a = 255;
-  
-  g_defaults.check.color.frame.r = 80;
-  g_defaults.check.color.frame.g = 80;
-  g_defaults.check.color.frame.b = 80;
-  g_defaults.check.color.frame.a = 200;
-  
-  g_defaults.check.color.background.r = 20;
-  g_defaults.check.color.background.g = 20;
-  g_defaults.check.color.background.b = 20;
-  g_defaults.check.color.background.a = 150;
-  
   /* slider */
   g_defaults.slider.flags.invert = 0;
   g_defaults.slider.flags.mouse_wheel = 1;
-  
-  g_defaults.slider.color.slider.r = 20;
-  g_defaults.slider.color.slider.g = 20;
-  g_defaults.slider.color.slider.b = 20;
-  g_defaults.slider.color.slider.a = 150;
-  
-  g_defaults.slider.color.frame.r = 80;
-  g_defaults.slider.color.frame.g = 80;
-  g_defaults.slider.color.frame.b = 80;
-  g_defaults.slider.color.frame.a = 200;
-  
-  g_defaults.slider.color.line.r = 80;
-  g_defaults.slider.color.line.g = 80;
-  g_defaults.slider.color.line.b = 80;
-  g_defaults.slider.color.line.a = 200;
+  g_defaults.slider.flags.changes_per_frame = 0;
   
   /* drop down list */
   g_defaults.drop_down.flags.mouse_wheel = 1;
   
-  g_defaults.drop_down.color.text.r = 180;
-  g_defaults.drop_down.color.text.g = 180;
-  g_defaults.drop_down.color.text.b = 180;
-  g_defaults.drop_down.color.text.a = 255;
-  
-  g_defaults.drop_down.color.frame.r = 80;
-  g_defaults.drop_down.color.frame.g = 80;
-  g_defaults.drop_down.color.frame.b = 80;
-  g_defaults.drop_down.color.frame.a = 200;
-  
-  g_defaults.drop_down.color.background.r = 50;
-  g_defaults.drop_down.color.background.g = 50;
-  g_defaults.drop_down.color.background.b = 50;
-  g_defaults.drop_down.color.background.a = 150;
-  
-  g_defaults.drop_down.color.background_list.r = 20;
-  g_defaults.drop_down.color.background_list.g = 20;
-  g_defaults.drop_down.color.background_list.b = 20;
-  g_defaults.drop_down.color.background_list.a = 150;
-  
-  g_defaults.drop_down.color.highlight.r = 80;
-  g_defaults.drop_down.color.highlight.g = 80;
-  g_defaults.drop_down.color.highlight.b = 80;
-  g_defaults.drop_down.color.highlight.a = 200;
-  
-  g_defaults.drop_down.color.arrow.r = 180;
-  g_defaults.drop_down.color.arrow.g = 180;
-  g_defaults.drop_down.color.arrow.b = 180;
-  g_defaults.drop_down.color.arrow.a = 255;
-  
   /* pop_up */
   g_defaults.pop_up_delay = 900;
   
-  g_defaults.pop_up.color.frame.r = 80;
-  g_defaults.pop_up.color.frame.g = 80;
-  g_defaults.pop_up.color.frame.b = 80;
-  g_defaults.pop_up.color.frame.a = 200;
-  
-  g_defaults.pop_up.color.background.r = 50;
-  g_defaults.pop_up.color.background.g = 50;
-  g_defaults.pop_up.color.background.b = 50;
-  g_defaults.pop_up.color.background.a = 150;
+  g_defaults.widget_event_mask = G_EVENT_MASK_ALL;
 }
 g_setting_struct *g_get_setting_struct(void)
 {
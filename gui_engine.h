@@ -33,10 +33,117 @@
 #define G_CHAR_W 8
 #define G_CHAR_H 12
 
+/* height of a single glyph in the SDL_gfx font */
+#define G_GLYPH_H 8
+
+/* amount of cached glyph sheets; each sheet contains the whole font in one color */
+#define G_GLYPH_SHEETS 32
+
+/* amount of cached gradients and the width of a single gradient strip */
+#define G_GRADIENT_STRIPS 32
+#define G_GRADIENT_STRIP_W 128
+
+/* amount of colors, whose pixel value is cached for the format of the destination surface */
+#define G_MAPPED_COLOR_BITS 7
+#define G_MAPPED_COLORS (1 << G_MAPPED_COLOR_BITS)
+
+/* maximal amount of separate damaged regions; further regions get merged */
+#define G_MAX_DAMAGE_RECTS 32
+
+/* maximal amount of threads used for rendering and the size of the tiles they draw */
+#define G_MAX_RENDER_THREADS 16
+#define G_RENDER_TILE_SIZE 128
+
+/* size of the first memory block, which the widgets of a window are allocated from */
+#define G_WIDGET_BLOCK_SIZE 2048
+
+/* size of the cells, which are used to find the widget below the mouse */
+#define G_HIT_GRID_CELL_SIZE 32
+
+/* amount of event function calls waiting for g_dispatch_events(), before queued mouse motion gets dropped */
+#define G_MAX_QUEUED_EVENTS 256
+
+/* maximal amount of events passed from SDL's event thread to the gui between two frames */
+#define G_MAX_INPUT_EVENTS 256
+
 struct g_color_struct{
   Uint8 r, g, b, a;
 };
 
+/* colors of windows and widgets, which are shared in a theme */
+struct g_window_colors{
+  struct g_color_struct frame;
+  struct g_color_struct background;
+  struct g_color_struct resize_mark;
+  
+  struct g_color_struct title_text;
+  struct g_color_struct title_bar_top;
+  struct g_color_struct title_bar_bottom;
+  
+  struct g_color_struct close_button_text;
+  struct g_color_struct close_button_top;
+  struct g_color_struct close_button_bottom;
+};
+
+struct g_text_colors{
+  struct g_color_struct text;
+};
+
+struct g_input_box_colors{
+  struct g_color_struct text;
+  struct g_color_struct frame;
+  struct g_color_struct background;
+  struct g_color_struct background_active;
+  struct g_color_struct cursor;
+};
+
+struct g_button_colors{
+  struct g_color_struct text;
+  struct g_color_struct frame;
+  struct g_color_struct top;
+  struct g_color_struct bottom;
+};
+
+struct g_check_box_colors{
+  struct g_color_struct mark;
+  struct g_color_struct frame;
+  struct g_color_struct background;
+};
+
+struct g_slider_colors{
+  struct g_color_struct slider;
+  struct g_color_struct frame;
+  struct g_color_struct line;
+};
+
+struct g_drop_down_list_colors{
+  struct g_color_struct text;
+  struct g_color_struct frame;
+  struct g_color_struct background;
+  struct g_color_struct background_list;
+  struct g_color_struct highlight;
+  struct g_color_struct arrow;
+};
+
+/* windows and widgets don't copy their colors, but point to a theme. changing the colors of a */
+/* theme and calling g_damage_theme() recolors all windows and widgets using it at once */
+typedef struct g_theme{
+  struct g_window_colors window;
+  
+  /* colors of pop-up windows */
+  struct g_window_colors pop_up;
+  
+  struct g_text_colors text;
+  struct g_input_box_colors input;
+  struct g_button_colors button;
+  struct g_check_box_colors check;
+  struct g_slider_colors slider;
+  struct g_drop_down_list_colors drop_down;
+  
+  /* only used by the engine; the theme is freed when the last reference is released */
+  int references;
+}g_theme;
+
 /* event types */
 typedef enum{
   G_UNDEFINED,
@@ -51,9 +158,14 @@ typedef enum{
   G_WHEEL_UP,
   G_WHEEL_DOWN,
   G_MOUSE_MOTION,
+  G_MOUSE_ENTER,
+  G_MOUSE_LEAVE,
   
   G_KEYDOWN,
-  G_KEYUP
+  G_KEYUP,
+  
+  /* the user has changed the value of a slider, check box, input box or drop down list */
+  G_VALUE_CHANGED
 }g_event_type;
 
 typedef struct{
@@ -72,7 +184,13 @@ typedef struct{
   SDLKey key;
 }g_event;
 
+/* event masks select the events, which are passed to an event function */
+#define G_EVENT_MASK(type) ((Uint32)1 << (type))
+#define G_EVENT_MASK_ALL 0xffffffff
+#define G_EVENT_MASK_CLICKS (G_EVENT_MASK(G_CLICK_LEFT) | G_EVENT_MASK(G_CLICK_MIDDLE) | G_EVENT_MASK(G_CLICK_RIGHT))
+
 /* widget defines */
+/* maximal length of widget texts, including the terminating '\0' */
 #define G_TEXT_LENGTH 4096
 #define G_CHECK_BOX_SIZE 15
 #define G_DROP_DOWN_LIST_SIZE 20
@@ -86,6 +204,9 @@ typedef struct{
 #define G_SLIDER_THICKNESS 2
 #define G_SLIDER_MOUSEWHEEL_STEP 0.05
 
+/* maximal amount of widget types, including the built-in types */
+#define G_MAX_WIDGET_TYPES 32
+
 /* widget types */
 typedef enum{
   G_TYPE_TEXT,
@@ -95,19 +216,23 @@ typedef enum{
   G_TYPE_SURFACE,
   G_TYPE_SLIDER_H,
   G_TYPE_SLIDER_V,
-  G_TYPE_DROP_DOWN_LIST
+  G_TYPE_DROP_DOWN_LIST,
+  
+  /* the first type returned by g_register_widget_type() */
+  G_TYPE_CUSTOM
 }g_widget_type;
 
 struct g_widget_text{
-  char text[G_TEXT_LENGTH];
+  /* use g_set_widget_text() to change it */
+  char *text;
   
-  struct{
-    struct g_color_struct text;
-  }color;
+  /* overrides the colors of the theme, if it is not NULL; the colors are not copied */
+  const struct g_text_colors *color;
 };
 
 struct g_widget_input_box{
-  char text[G_TEXT_LENGTH];
+  /* grows while typing; use g_set_widget_text() to change it */
+  char *text;
   
   /* you can set a maximum of characters in the input box */
   /* if this value is smaller then 0, or bigger then G_TEXT_LENGTH, 'limit' it is ignored */
@@ -143,13 +268,8 @@ struct g_widget_input_box{
     int key_repeat:1;
   }flags;
   
-  struct{
-    struct g_color_struct text;
-    struct g_color_struct frame;
-    struct g_color_struct background;
-    struct g_color_struct background_active;
-    struct g_color_struct cursor;
-  }color;
+  /* overrides the colors of the theme, if it is not NULL; the colors are not copied */
+  const struct g_input_box_colors *color;
   
   /* the following variables are only used by the widget itself */
   /* dont change/access them, unless you know what you are doing */
@@ -165,27 +285,24 @@ struct g_widget_input_box{
   
   /* width of input box in characters */
   int char_amount_w;
+  
+  /* size of the memory allocated for 'text' */
+  int text_size;
 };
 
 struct g_widget_button{
-  char text[G_TEXT_LENGTH];
+  /* use g_set_widget_text() to change it */
+  char *text;
   
-  struct{
-    struct g_color_struct text;
-    struct g_color_struct frame;
-    struct g_color_struct top;
-    struct g_color_struct bottom;
-  }color;
+  /* overrides the colors of the theme, if it is not NULL; the colors are not copied */
+  const struct g_button_colors *color;
 };
 
 struct g_widget_check_box{
   int state:1;
   
-  struct{
-    struct g_color_struct mark;
-    struct g_color_struct frame;
-    struct g_color_struct background;
-  }color;
+  /* overrides the colors of the theme, if it is not NULL; the colors are not copied */
+  const struct g_check_box_colors *color;
 };
 
 struct g_widget_surface{
@@ -203,18 +320,30 @@ struct g_widget_slider{
     
     /* allows usage of mouse wheel to change slider value */
     int mouse_wheel:1;
+    
+    /* while dragging, G_VALUE_CHANGED is sent at most once per frame */
+    int changes_per_frame:1;
   }flags;
   
-  struct{
-    struct g_color_struct slider;
-    struct g_color_struct frame;
-    struct g_color_struct line;
-  }color;
+  /* overrides the colors of the theme, if it is not NULL; the colors are not copied */
+  const struct g_slider_colors *color;
+};
+
+/* position of an item inside the text of a drop down list */
+struct g_drop_down_item{
+  int offset;
+  int length;
 };
 
 struct g_widget_drop_down_list{
-  /* items are seperated by '\n' in 'text' */
-  char text[G_TEXT_LENGTH];
+  /* items are seperated by '\n' in 'text'; use g_set_drop_down_list_text() to change them */
+  char *text;
+  
+  /* index of all items in 'text', with 'max_item' + 1 entries */
+  struct g_drop_down_item *items;
+  
+  /* length of the longest item in characters */
+  int max_length;
   
   int current_item;
   int max_item;
@@ -224,14 +353,20 @@ struct g_widget_drop_down_list{
     int mouse_wheel:1;
   }flags;
   
-  struct{
-    struct g_color_struct text;
-    struct g_color_struct frame;
-    struct g_color_struct background;
-    struct g_color_struct background_list;
-    struct g_color_struct highlight;
-    struct g_color_struct arrow;
-  }color;
+  /* overrides the colors of the theme, if it is not NULL; the colors are not copied */
+  const struct g_drop_down_list_colors *color;
+};
+
+/* the layout of a widget is cached, as long as its position and the window geometry dont change */
+struct g_widget_layout{
+  int valid;
+  
+  /* values the layout was calculated with */
+  int widget_x, widget_y;
+  int window_w, window_h, window_margin;
+  
+  /* calculated position and size inside the window */
+  int x, y, w, h;
 };
 
 typedef struct g_widget{
@@ -242,17 +377,6 @@ typedef struct g_widget{
   /* if you set w and/or h to 0, the widget will be as big as the possible, but not bigger than the window */
   int x, y, w, h;
   
-  /* widgets */
-  union{
-    struct g_widget_text text;
-    struct g_widget_input_box input;
-    struct g_widget_button button;
-    struct g_widget_check_box check;
-    struct g_widget_surface surface;
-    struct g_widget_slider slider;
-    struct g_widget_drop_down_list drop_down;
-  };
-  
   /* this is something like a tooltip, which can be filled with widgets, but disappears if mouse leave pop_up */
   struct g_window *pop_up;
   
@@ -266,14 +390,89 @@ typedef struct g_widget{
   /* pointer to some data. this data is passed to the event function if any event occurs */
   void *event_data;
   
+  /* only events in this mask are passed to the event function, i.e. G_EVENT_MASK_CLICKS */
+  /* to ignore mouse motion. the default is set in the g_setting_struct */
+  Uint32 event_mask;
+  
+  /* the theme of the widget; NULL uses the theme of the window. use g_set_widget_theme() to change it */
+  struct g_theme *theme;
+  
   /* do not assign this pointers, unless you know what you are doing */
   /* in most cases the engine will do this for you */
   struct g_window *window;
   
   struct g_widget *next;
   struct g_widget *prev;
+  
+  /* only used by the engine; text changes must be reported with g_damage_widget() */
+  struct g_widget_layout layout;
+  
+  /* widgets */
+  /* this must stay the last member, since every widget is allocated with the size of its type */
+  union{
+    struct g_widget_text text;
+    struct g_widget_input_box input;
+    struct g_widget_button button;
+    struct g_widget_check_box check;
+    struct g_widget_surface surface;
+    struct g_widget_slider slider;
+    struct g_widget_drop_down_list drop_down;
+    
+    /* data of a custom widget type */
+    void *custom;
+  };
 }g_widget;
 
+/* every widget type has a class, which contains the functions used by the engine */
+/* all positions are relative to the window body, like the position of the widget. the areas */
+/* are cached until the widget is damaged with g_damage_widget() */
+typedef struct{
+  /* draws the widget into the window body at window_x/window_y */
+  /* with render threads, several widgets are drawn at the same time, so it must not change anything */
+  void (*draw)(SDL_Surface *dst, const g_widget *widget, const int window_x, const int window_y);
+  
+  /* stores the area, which the widget draws to */
+  void (*get_area)(const g_widget *widget, int *x, int *y, int *w, int *h);
+  
+  /* stores the area, which reacts to the mouse, and returns 1; returns 0 if the widget can not be hit */
+  /* if it is NULL, the widget does not receive mouse events */
+  int (*get_hit_area)(const g_widget *widget, int *x, int *y, int *w, int *h);
+  
+  /* called for mouse events inside the hit area, before the event function of the widget */
+  /* event->x/y is the mouse position inside the hit area, w/h its size. can be NULL */
+  void (*handle_event)(g_widget *widget, const g_event *event, const int w, const int h);
+  
+  /* frees the data of the widget; can be NULL */
+  void (*destroy)(g_widget *widget);
+}g_widget_class;
+
+/* area of a widget inside the window body */
+struct g_widget_rect{
+  int x, y, w, h;
+};
+
+/* the widgets of a window are sorted into a grid of cells, to speed up mouse events */
+/* every cell contains a list of widget indices terminated by -1, topmost widget first */
+struct g_hit_grid{
+  int valid;
+  
+  /* values the grid was built with */
+  int window_w, window_h, window_margin;
+  
+  int columns, rows;
+  
+  /* index of the first list entry of every cell */
+  int *cells;
+  int *entries;
+  
+  /* packed areas of all widgets in drawing order, which drawing and hit testing run through */
+  /* widgets, which can not be hit, have an empty hit area */
+  int widget_amount;
+  struct g_widget **widgets;
+  struct g_widget_rect *areas;
+  struct g_widget_rect *hit_areas;
+};
+
 /* window defines */
 #define G_WINDOW_TITLE_LENGTH 128
 #define G_WINDOW_TITLE_BAR_HEIGHT 20
@@ -297,6 +496,10 @@ struct g_window_flags{
   
   /* keep window ratio while resizing */
   int keep_ratio:1;
+  
+  /* keep a copy of the drawn window and only redraw it after it has changed */
+  /* this is only used for windows, whose frame, background and title bar are opaque */
+  int cached:1;
 };
 
 typedef struct g_window{
@@ -319,26 +522,18 @@ typedef struct g_window{
   /* this margin effects only the gap between window frame and widget */
   int margin;
   
-  /* colors */
-  struct{
-    struct g_color_struct frame;
-    struct g_color_struct background;
-    struct g_color_struct resize_mark;
-    
-    struct g_color_struct title_text;
-    struct g_color_struct title_bar_top;
-    struct g_color_struct title_bar_bottom;
-    
-    struct g_color_struct close_button_text;
-    struct g_color_struct close_button_top;
-    struct g_color_struct close_button_bottom;
-  }color;
+  /* the theme of the window and its widgets; NULL uses the default theme. use g_set_window_theme() to change it */
+  struct g_theme *theme;
+  
+  /* overrides the colors of the theme, if it is not NULL; the colors are not copied */
+  const struct g_window_colors *color;
   
   /* this function is called, if any event occurs inside the window */
   void (*event_function)(const g_event *, struct g_window *, void *);
   
   /* same as in g_widget */
   void *event_data;
+  Uint32 event_mask;
   
   /* do not assign this pointers, unless you know what you are doing */
   /* in most cases the engine will do this for you */
@@ -347,10 +542,25 @@ typedef struct g_window{
   
   struct g_window *next;
   struct g_window *prev;
+  
+  /* the drawn window, if the 'cached' flag is enabled */
+  SDL_Surface *cache;
+  int cache_valid;
+  
+  /* only used by the engine to find widgets below the mouse */
+  struct g_hit_grid hit_grid;
+  
+  /* only used by the engine; the widgets are allocated from these blocks, which are freed with the window */
+  struct g_widget_block *widget_blocks;
+  struct g_unused_widget *unused_widgets;
+  
+  /* only used by the engine; pop-up windows use the pop-up colors of the theme */
+  int is_pop_up;
 }g_window;
 
 /* setting struct */
 /* this struct contains the default settings, which are applied to new windows and widgets */
+/* their colors are stored in the default theme instead */
 typedef struct{
   /* window defaults */
   struct{
@@ -361,31 +571,10 @@ typedef struct{
     
     char close_button_character;
     int margin;
-    
-    /* colors */
-    struct{
-      struct g_color_struct frame;
-      struct g_color_struct background;
-      struct g_color_struct resize_mark;
-      
-      struct g_color_struct title_text;
-      struct g_color_struct title_bar_top;
-      struct g_color_struct title_bar_bottom;
-      
-      struct g_color_struct close_button_text;
-      struct g_color_struct close_button_top;
-      struct g_color_struct close_button_bottom;
-    }color;
+    Uint32 event_mask;
   }window;
   
   /* widget defaults */
-  /* text */
-  struct{
-    struct{
-      struct g_color_struct text;
-    }color;
-  }text;
-  
   /* input box */
   struct{
     char replace_character;
@@ -404,47 +593,15 @@ typedef struct{
       int special_chars:1;
       int key_repeat:1;
     }flags;
-    
-    struct{
-      struct g_color_struct text;
-      struct g_color_struct frame;
-      struct g_color_struct background;
-      struct g_color_struct background_active;
-      struct g_color_struct cursor;
-    }color;
   }input;
   
-  /* button */
-  struct{
-    struct{
-      struct g_color_struct text;
-      struct g_color_struct frame;
-      struct g_color_struct top;
-      struct g_color_struct bottom;
-    }color;
-  }button;
-  
-  /* check box */
-  struct{
-    struct{
-      struct g_color_struct mark;
-      struct g_color_struct frame;
-      struct g_color_struct background;
-    }color;
-  }check;
-  
   /* slider */
   struct{
     struct{
       int invert:1;
       int mouse_wheel:1;
+      int changes_per_frame:1;
     }flags;
-    
-    struct{
-      struct g_color_struct slider;
-      struct g_color_struct frame;
-      struct g_color_struct line;
-    }color;
   }slider;
   
   /* drop down list */
@@ -452,26 +609,13 @@ typedef struct{
     struct{
       int mouse_wheel:1;
     }flags;
-    
-    struct{
-      struct g_color_struct text;
-      struct g_color_struct frame;
-      struct g_color_struct background;
-      struct g_color_struct background_list;
-      struct g_color_struct highlight;
-      struct g_color_struct arrow;
-    }color;
   }drop_down;
   
   /* pop_up */
-  struct{
-    struct{
-      struct g_color_struct frame;
-      struct g_color_struct background;
-    }color;
-  }pop_up;
-  
   Uint32 pop_up_delay;
+  
+  /* event mask of new widgets */
+  Uint32 widget_event_mask;
 }g_setting_struct;
 
 /* widget functions */
@@ -485,8 +629,26 @@ extern g_widget *g_attach_surface(g_window *window, const int x, const int y, co
 extern g_widget *g_attach_slider_h(g_window *window, const int x, const int y, const int w, const double value, const double max_value);
 extern g_widget *g_attach_slider_v(g_window *window, const int x, const int y, const int h, const double value, const double max_value);
 extern g_widget *g_attach_drop_down_list(g_window *window, const int x, const int y, const int w, const char *text);
+
+/* replaces all items of the drop down list with 'text'; returns 0 on failure */
+extern int g_set_drop_down_list_text(g_widget *widget, const char *text);
+
+/* replaces the text of a text, button or input box widget; returns 0 on failure */
+/* texts longer than G_TEXT_LENGTH - 1 characters are cut off */
+extern int g_set_widget_text(g_widget *widget, const char *text);
+
+/* attaches a widget of a type registered with g_register_widget_type(); 'data' is stored in widget->custom */
+extern g_widget *g_attach_custom_widget(g_window *window, const int type, const int x, const int y, const int w, const int h, void *data);
+
+/* adds a widget type, which is drawn and handled by the functions in 'widget_class' */
+/* the class is copied; draw and get_area are required. returns the new type, or -1 on failure */
+extern int g_register_widget_type(const g_widget_class *widget_class);
 extern void g_destroy_widget(g_widget *widget);
 
+/* marks the widget for redrawing by g_draw_damaged() */
+/* call this after changing the widget directly, i.e. its text, state or colors; this also updates its cached layout */
+extern void g_damage_widget(g_widget *widget);
+
 extern void g_enter_input_box(g_widget *widget);
 extern void g_leave_input_box(void);
 
@@ -495,6 +657,10 @@ extern g_window *g_create_window(const int x, const int y, const int w, const in
 extern void g_destroy_window(g_window *window);
 extern void g_raise_window(g_window *window);
 
+/* marks the whole window for redrawing by g_draw_damaged() */
+/* if you move, resize or hide a window directly, call this before and after the change */
+extern void g_damage_window(g_window *window);
+
 /* attention: window cant get bigger then window max_w/h */
 extern void g_maximize_window(g_window *window);
 extern void g_maximize_window_h(g_window *window);
@@ -506,6 +672,31 @@ extern g_window *g_create_pop_up_window(const int w, const int h);
 extern void g_open_pop_up(g_window *window);
 extern void g_close_pop_up(void);
 
+/* theme functions */
+/* returns a copy of the default theme, or NULL on failure. the caller owns one reference */
+extern g_theme *g_create_theme(void);
+
+/* drops one reference; the theme is freed after its last reference was dropped */
+extern void g_release_theme(g_theme *theme);
+
+/* sets all colors of the theme to the built-in colors */
+extern void g_reset_theme(g_theme *theme);
+
+/* windows and widgets keep their own reference to the theme; NULL removes the theme again */
+extern void g_set_window_theme(g_window *window, g_theme *theme);
+extern void g_set_widget_theme(g_widget *widget, g_theme *theme);
+
+/* the default theme is used by windows without an own theme. its colors can be changed directly */
+extern g_theme *g_get_default_theme(void);
+extern void g_set_default_theme(g_theme *theme);
+
+/* returns the theme the widget is drawn with, i.e. for the draw function of custom widgets */
+extern const g_theme *g_get_widget_theme(const g_widget *widget);
+
+/* marks all windows and widgets using the theme for redrawing by g_draw_damaged() */
+/* call this after changing the colors of a theme */
+extern void g_damage_theme(const g_theme *theme);
+
 /* engine functions */
 /* you need to call this function to be able to use the engine, even before you create any window */
 /* returns 1 on success, 0 on failure */
@@ -515,6 +706,59 @@ extern int g_init_everything(void);
 extern void g_destroy_everything(void);
 extern void g_draw_everything(SDL_Surface *dst);
 
+/* redraws only the regions which have changed since the last call */
+/* the redrawn regions are stored in 'rects', which can hold up to 'max' regions, and can be */
+/* passed to SDL_UpdateRects(); returns the amount of regions stored in 'rects' */
+extern int g_draw_damaged(SDL_Surface *dst, SDL_Rect *rects, const int max);
+
+/* marks the whole video surface for redrawing, i.e. after the screen was cleared */
+extern void g_damage_everything(void);
+
+/* returns 1 if anything has changed since the last call of g_draw_everything() or g_draw_damaged() */
+/* when an event handled by the gui damages something, a SDL_VIDEOEXPOSE event is pushed to */
+/* wake up programs waiting in SDL_WaitEvent() */
+extern int g_needs_redraw(void);
+
+/* returns the time in milliseconds until something changes without user input, like an opening */
+/* pop-up window, or -1 if nothing is scheduled */
+extern int g_get_redraw_timeout(void);
+
+/* this function is called by g_draw_damaged() to redraw the background of a damaged region */
+/* the clip rect of 'dst' is set to 'rect' while this function is called. function example: */
+/* void example_function(SDL_Surface *dst, const SDL_Rect *rect, void *data); */
+extern void g_set_background_function(void (*function)(SDL_Surface *, const SDL_Rect *, void *), void *data);
+
+/* draw with 'amount' threads; the destination surface gets split into tiles, which are drawn in parallel */
+/* 0 or 1 disables parallel rendering. returns the amount of threads used */
+/* the background function is always called from the thread, which calls g_draw_damaged() */
+/* opaque text is drawn by all threads at once, but translucent text and gradients, and surfaces */
+/* of other formats, are blitted by one thread at a time */
+extern int g_set_render_threads(const int amount);
+
+/* merge mouse motion events until the next call of g_needs_redraw(), g_draw_damaged() or */
+/* g_draw_everything(), or until any other event arrives. the positions of the last event and the */
+/* summed up relative motion are used, so dragging windows and sliders is done once per frame */
+/* merged events, which are not used by the gui, are pushed to the event queue again */
+extern void g_set_motion_coalescing(const int enable);
+
+/* don't call event functions while SDL filters events, but queue the calls until g_dispatch_events() */
+/* is called. this way event functions can take their time and destroy any window or widget. calls */
+/* to destroyed windows/widgets are dropped. successive mouse motion, window move and resize calls */
+/* to the same window/widget are merged, and beyond G_MAX_QUEUED_EVENTS calls the oldest mouse */
+/* motion gets dropped. other calls, like clicks and value changes, are never dropped */
+/* disabling calls all queued functions */
+extern void g_set_deferred_events(const int enable);
+
+/* calls the queued event functions in order; returns the amount of called functions */
+extern int g_dispatch_events(void);
+
+/* call this after g_init_everything(), if SDL was initialized with SDL_INIT_EVENTTHREAD. the event */
+/* filter then runs on SDL's event thread and only passes the events on, without touching the gui */
+/* they are handled by the next call of g_needs_redraw(), g_draw_damaged(), g_draw_everything() or */
+/* g_dispatch_events() in the drawing thread. events not used by the gui are pushed to the event */
+/* queue again, after any events already waiting there. disabling handles all passed events */
+extern void g_set_threaded_events(const int enable);
+
 /* set all settings in the g_setting_struct to default */
 extern void g_reset_settings(void);
 